@@ -87,7 +87,38 @@ bool Sub(Stack *s) {
 
 
 bool Mul(Stack *s) {
-    return BinaryOperation(s, PolyMul);
+    if (s->deg_bound == NO_DEG_BOUND)
+        return BinaryOperation(s, PolyMul);
+    if (s->size < 2)
+        return false;
+    Poly p = Pop(s);
+    Poly q = Pop(s);
+    Poly result = PolyMulTrunc(&p, &q, s->deg_bound);
+    Push(s, &result);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+    return true;
+}
+
+bool MulAdd(Stack *s) {
+    if (s->size < 3)
+        return false;
+    Poly p = Pop(s);
+    Poly q = Pop(s);
+    Poly r = Pop(s);
+    if (s->deg_bound == NO_DEG_BOUND)
+        PolyMulAdd(&r, &p, &q);
+    else {
+        Poly product = PolyMulTrunc(&p, &q, s->deg_bound);
+        Poly sum = PolyAdd(&r, &product);
+        PolyDestroy(&product);
+        PolyDestroy(&r);
+        r = sum;
+    }
+    Push(s, &r);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+    return true;
 }
 
 bool IsEq(Stack *s) {
@@ -138,31 +169,48 @@ bool At(Stack *s, poly_coeff_t x) {
     return true;
 }
 
-static void PrintPoly(Poly p);
-
-/**
- * Wypisuje jednomian na standardowe wyjście.
- * @param m : jednomian
- */
-static void PrintMono(Mono m) {
-    printf("(");
-    PrintPoly(m.p);
-    printf(",%d)", m.exp);
-}
+/** Liczba poziomów stosu iteratora wypisującego wielomian bez alokacji. */
+#define PRINT_STACK_SIZE 64
 
 /**
- * Wypisuje wielomian na standardowe wyjście.
+ * Wypisuje wielomian na standardowe wyjście. Przechodzi składniki
+ * iteratorem, otwierając i zamykając nawiasy jednomianów na granicach
+ * wspólnych prefiksów kolejnych składników. Pamięć jest alokowana tylko dla
+ * wielomianów głębszych niż @ref PRINT_STACK_SIZE.
  * @param[in] p : wielomian
  */
-static void PrintPoly(Poly p) {
-    if (PolyIsCoeff(&p))
-        printf("%ld", p.coeff);
-    else {
-        for (size_t i = 0; i < p.size; i++) {
-            PrintMono(p.arr[i]);
-            if (i != p.size - 1)
-                printf("+");
-        }
+static void PrintPoly(const Poly *p) {
+    if (PolyIsZero(p)) {
+        putchar('0');
+        return;
+    }
+
+    PolyTermFrame frames_buffer[PRINT_STACK_SIZE];
+    poly_exp_t exps_buffer[PRINT_STACK_SIZE];
+    PolyTermFrame *frames = frames_buffer;
+    poly_exp_t *exps = exps_buffer;
+    size_t depth = PolyDepth(p);
+    if (depth > PRINT_STACK_SIZE) {
+        frames = malloc(depth * sizeof(PolyTermFrame));
+        exps = malloc(depth * sizeof(poly_exp_t));
+        if (frames == NULL || exps == NULL) exit(1);
+    }
+
+    PolyTermIter it;
+    PolyTermIterInit(&it, p, frames, exps, depth);
+    while (PolyTermIterNext(&it)) {
+        for (size_t level = it.shared; level < it.depth; level++)
+            putchar('(');
+        printf("%ld", it.coeff);
+        for (size_t level = it.depth; level-- > it.next_shared;)
+            printf(",%d)", it.exps[level]);
+        if (it.has_next)
+            putchar('+');
+    }
+
+    if (frames != frames_buffer) {
+        free(frames);
+        free(exps);
     }
 }
 
@@ -170,7 +218,7 @@ bool Print(Stack *s) {
     if (IsEmpty(s))
         return false;
     Poly p = Top(s);
-    PrintPoly(p);
+    PrintPoly(&p);
     printf("\n");
     return true;
 }
@@ -192,7 +240,8 @@ bool Compose(Stack *s, size_t k) {
         tab[k - i] = Pop(s);
     }
 
-    Poly res = PolyCompose(&p, k, tab);
+    Poly res = s->deg_bound == NO_DEG_BOUND ? PolyCompose(&p, k, tab)
+                                            : PolyComposeTrunc(&p, k, tab, s->deg_bound);
     Push(s, &res);
     PolyDestroy(&p);
     for (size_t i = 0; i < k; i++) {
@@ -201,3 +250,169 @@ bool Compose(Stack *s, size_t k) {
     free(tab);
     return true;
 }
+
+bool Sum(Stack *s, size_t n) {
+    if (s->size < n)
+        return false;
+    if (n == 0) {
+        Poly zero = PolyZero();
+        Push(s, &zero);
+        return true;
+    }
+    Poly *tab = malloc(n * sizeof(Poly));
+    if (tab == NULL)
+        exit(1);
+
+    for (size_t i = 0; i < n; i++)
+        tab[i] = Pop(s);
+
+    Poly res = PolyAddMany(n, tab);
+    Push(s, &res);
+    for (size_t i = 0; i < n; i++)
+        PolyDestroy(&tab[i]);
+    free(tab);
+    return true;
+}
+
+bool Subst(Stack *s, size_t idx) {
+    if (s->size < 2)
+        return false;
+    Poly p = Pop(s);
+    Poly q = Pop(s);
+    Poly result = PolySubstitute(&p, idx, &q);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+    Push(s, &result);
+    return true;
+}
+
+bool Eval(Stack *s, size_t k, const size_t vars[], const poly_coeff_t values[]) {
+    if (IsEmpty(s))
+        return false;
+    Poly p = Pop(s);
+    Poly result = PolyAtMany(&p, k, vars, values);
+    PolyDestroy(&p);
+    Push(s, &result);
+    return true;
+}
+
+bool Shift(Stack *s, size_t idx, poly_coeff_t a) {
+    if (IsEmpty(s))
+        return false;
+    Poly p = Pop(s);
+    Poly result = PolyShift(&p, idx, a);
+    PolyDestroy(&p);
+    Push(s, &result);
+    return true;
+}
+
+void Trunc(Stack *s, poly_exp_t d) {
+    s->deg_bound = d;
+}
+
+/**
+ * Wykonuje działanie na szeregu potęgowym z wierzchołka stosu. Jeśli wynik
+ * istnieje, zastępuje nim wielomian z wierzchołka, a w przeciwnym przypadku
+ * nie zmienia stosu. Zwraca @p false, gdy na stosie nie ma żadnych
+ * wielomianów.
+ * @param[in,out] s : stos
+ * @param[in] n : liczba współczynników wyniku
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @param[out] defined : czy wynik istnieje
+ * @param[in] op : działanie na szeregu
+ * @return Czy operacja się powiodła?
+ */
+static bool SeriesOperation(Stack *s, poly_exp_t n, poly_coeff_t m, bool *defined,
+                            bool (*op)(const Poly *, poly_exp_t, poly_coeff_t, Poly *)) {
+    if (IsEmpty(s))
+        return false;
+    Poly p = Top(s), result;
+    *defined = (*op)(&p, n, m, &result);
+    if (*defined) {
+        p = Pop(s);
+        PolyDestroy(&p);
+        Push(s, &result);
+    }
+    return true;
+}
+
+bool InvSeries(Stack *s, poly_exp_t n, poly_coeff_t m, bool *defined) {
+    return SeriesOperation(s, n, m, defined, PolySeriesInv);
+}
+
+bool SqrtSeries(Stack *s, poly_exp_t n, poly_coeff_t m, bool *defined) {
+    return SeriesOperation(s, n, m, defined, PolySeriesSqrt);
+}
+
+bool ExpSeries(Stack *s, poly_exp_t n, poly_coeff_t m, bool *defined) {
+    return SeriesOperation(s, n, m, defined, PolySeriesExp);
+}
+
+/**
+ * Dzieli z resztą wielomian z wierzchołka stosu przez wielomian pod
+ * wierzchołkiem i zastępuje je ilorazem lub resztą.
+ * @param[in,out] s : stos
+ * @param[out] monic : czy dzielnik jest unormowany
+ * @param[in] keep_quotient : czy na stos trafia iloraz zamiast reszty
+ * @return Czy na stosie były co najmniej dwa wielomiany?
+ */
+static bool DivOperation(Stack *s, bool *monic, bool keep_quotient) {
+    if (s->size < 2)
+        return false;
+    Poly p = Top(s), d = SecondTop(s), q, r;
+    *monic = PolyDivRem(&p, &d, &q, &r);
+    if (*monic) {
+        p = Pop(s);
+        d = Pop(s);
+        PolyDestroy(&p);
+        PolyDestroy(&d);
+        Push(s, keep_quotient ? &q : &r);
+        PolyDestroy(keep_quotient ? &r : &q);
+    }
+    return true;
+}
+
+bool Div(Stack *s, bool *monic) {
+    return DivOperation(s, monic, true);
+}
+
+bool Rem(Stack *s, bool *monic) {
+    return DivOperation(s, monic, false);
+}
+
+bool MulMono(Stack *s, size_t idx, poly_exp_t e, poly_coeff_t c) {
+    if (IsEmpty(s))
+        return false;
+    Poly p = Pop(s);
+    PolyMulMono(&p, idx, e, c);
+    Push(s, &p);
+    return true;
+}
+
+bool Reorder(Stack *s) {
+    if (IsEmpty(s))
+        return false;
+    Poly p = Pop(s);
+    size_t k = PolyDepth(&p);
+    size_t *perm = malloc((k == 0 ? 1 : k) * sizeof(size_t));
+    if (perm == NULL)
+        exit(1);
+
+    PolyBestVarOrder(&p, k, perm);
+    Poly result = PolyPermuteVars(&p, k, perm);
+    PolyDestroy(&p);
+    Push(s, &result);
+    for (size_t i = 0; i < k; i++)
+        printf(i == 0 ? "%zu" : " %zu", perm[i]);
+    printf("\n");
+    free(perm);
+    return true;
+}
+
+bool Coeff(Stack *s, size_t k, const poly_exp_t exps[]) {
+    if (IsEmpty(s))
+        return false;
+    Poly p = Top(s);
+    printf("%ld\n", PolyCoeffOf(&p, k, exps));
+    return true;
+}
@@ -80,6 +80,15 @@ bool Sub(Stack *s);
  */
 bool Mul(Stack *s);
 
+/**
+ * Zdejmuje ze stosu kolejno wielomiany @f$p@f$, @f$q@f$ i @f$r@f$ i wstawia na
+ * wierzchołek stosu @f$r + p * q@f$. Jeśli na stosie są mniej niż trzy
+ * wielomiany, nie wykonuje działania i zwraca @p false.
+ * @param[in,out] s : stos
+ * @return Czy operacja się powiodła?
+ */
+bool MulAdd(Stack *s);
+
 /**
  * Wypisuje na standardowe wyjście @p 1, jeśli dwa wielomiany na wierzchu stosu
  * są równe, w przeciwnym przypadku wypisuje @p 0. Jeśli na stosie są mniej niż
@@ -142,4 +151,148 @@ bool Print(Stack *s);
  */
 bool Compose(Stack *s, size_t k);
 
+/**
+ * Zdejmuje z wierzchołka stosu @p n wielomianów i wstawia na stos ich sumę.
+ * Jeśli na stosie jest mniej niż @p n wielomianów, nie wykonuje działania
+ * i zwraca @p false.
+ * @param[in,out] s : stos
+ * @param[in] n : liczba sumowanych wielomianów
+ * @return Czy operacja się powiodła?
+ */
+bool Sum(Stack *s, size_t n);
+
+/**
+ * Zdejmuje z wierzchołka stosu wielomian @f$p@f$, a następnie wielomian
+ * @f$q@f$ i wstawia na stos wynik podstawienia @f$q@f$ za zmienną
+ * @f$x_{idx}@f$ w @f$p@f$. Jeśli na stosie są mniej niż dwa wielomiany,
+ * nie wykonuje działania i zwraca @p false.
+ * @param[in,out] s : stos
+ * @param[in] idx : indeks zmiennej
+ * @return Czy operacja się powiodła?
+ */
+bool Subst(Stack *s, size_t idx);
+
+/**
+ * Wylicza wartość wielomianu z wierzchołka stosu w punktach @p values dla
+ * zmiennych o rosnących indeksach @p vars. Usuwa wielomian z wierzchołka
+ * i wstawia na stos wielomian pozostałych zmiennych.
+ * Zwraca @p false, gdy na stosie nie ma żadnych wielomianów.
+ * @param[in,out] s : stos
+ * @param[in] k : liczba ustalanych zmiennych
+ * @param[in] vars : indeksy zmiennych
+ * @param[in] values : wartości zmiennych
+ * @return Czy operacja się powiodła?
+ */
+bool Eval(Stack *s, size_t k, const size_t vars[], const poly_coeff_t values[]);
+
+/**
+ * Podstawia @f$x_{idx} + a@f$ za zmienną @f$x_{idx}@f$ w wielomianie
+ * z wierzchołka stosu, usuwa go i wstawia na stos wynik.
+ * Zwraca @p false, gdy na stosie nie ma żadnych wielomianów.
+ * @param[in,out] s : stos
+ * @param[in] idx : indeks zmiennej
+ * @param[in] a : przesunięcie
+ * @return Czy operacja się powiodła?
+ */
+bool Shift(Stack *s, size_t idx, poly_coeff_t a);
+
+/**
+ * Mnoży wielomian z wierzchołka stosu przez jednomian
+ * @f$c \cdot x_{idx}^e@f$, nie zdejmując go ze stosu.
+ * Zwraca @p false, gdy na stosie nie ma żadnych wielomianów.
+ * @param[in,out] s : stos
+ * @param[in] idx : indeks zmiennej
+ * @param[in] e : wykładnik
+ * @param[in] c : współczynnik
+ * @return Czy operacja się powiodła?
+ */
+bool MulMono(Stack *s, size_t idx, poly_exp_t e, poly_coeff_t c);
+
+/**
+ * Ustawia ograniczenie stopnia wyników kolejnych operacji. Wielomiany
+ * wstawiane na stos są obcinane do jednomianów stopnia co najwyżej @p d,
+ * a mnożenie i składanie pomijają wyższe jednomiany już w trakcie liczenia.
+ * Wielomiany, które są już na stosie, nie są zmieniane.
+ * @param[in,out] s : stos
+ * @param[in] d : nieujemne ograniczenie stopnia lub @ref NO_DEG_BOUND, aby
+ * je wyłączyć
+ */
+void Trunc(Stack *s, poly_exp_t d);
+
+/**
+ * Zastępuje wielomian z wierzchołka stosu odwrotnością szeregu potęgowego
+ * modulo @f$x^n@f$ i modulo @p m (patrz @ref PolySeriesInv). Jeśli
+ * odwrotność nie istnieje, nie zmienia stosu.
+ * Zwraca @p false, gdy na stosie nie ma żadnych wielomianów.
+ * @param[in,out] s : stos
+ * @param[in] n : liczba współczynników wyniku
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @param[out] defined : czy wynik istnieje
+ * @return Czy operacja się powiodła?
+ */
+bool InvSeries(Stack *s, poly_exp_t n, poly_coeff_t m, bool *defined);
+
+/**
+ * Zastępuje wielomian z wierzchołka stosu pierwiastkiem kwadratowym szeregu
+ * potęgowego (patrz @ref PolySeriesSqrt), tak jak @ref InvSeries.
+ * @param[in,out] s : stos
+ * @param[in] n : liczba współczynników wyniku
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @param[out] defined : czy wynik istnieje
+ * @return Czy operacja się powiodła?
+ */
+bool SqrtSeries(Stack *s, poly_exp_t n, poly_coeff_t m, bool *defined);
+
+/**
+ * Zastępuje wielomian z wierzchołka stosu eksponentą szeregu potęgowego
+ * (patrz @ref PolySeriesExp), tak jak @ref InvSeries.
+ * @param[in,out] s : stos
+ * @param[in] n : liczba współczynników wyniku
+ * @param[in] m : moduł
+ * @param[out] defined : czy wynik istnieje
+ * @return Czy operacja się powiodła?
+ */
+bool ExpSeries(Stack *s, poly_exp_t n, poly_coeff_t m, bool *defined);
+
+/**
+ * Dzieli z resztą wielomian z wierzchołka stosu przez wielomian pod
+ * wierzchołkiem (patrz @ref PolyDivRem), usuwa je i wstawia na stos iloraz.
+ * Jeśli dzielnik nie jest unormowany względem zmiennej głównej, nie zmienia
+ * stosu. Zwraca @p false, gdy na stosie są mniej niż dwa wielomiany.
+ * @param[in,out] s : stos
+ * @param[out] monic : czy dzielnik jest unormowany
+ * @return Czy operacja się powiodła?
+ */
+bool Div(Stack *s, bool *monic);
+
+/**
+ * Dzieli z resztą wielomian z wierzchołka stosu przez wielomian pod
+ * wierzchołkiem, tak jak @ref Div, ale wstawia na stos resztę.
+ * @param[in,out] s : stos
+ * @param[out] monic : czy dzielnik jest unormowany
+ * @return Czy operacja się powiodła?
+ */
+bool Rem(Stack *s, bool *monic);
+
+/**
+ * Zmienia kolejność zmiennych wielomianu z wierzchołka stosu tak, aby jego
+ * reprezentacja była możliwie mała, i wypisuje na standardowe wyjście
+ * permutację: dla kolejnych zmiennych @f$x_i@f$ ich nowe numery.
+ * Zwraca @p false, gdy na stosie nie ma żadnych wielomianów.
+ * @param[in,out] s : stos
+ * @return Czy operacja się powiodła?
+ */
+bool Reorder(Stack *s);
+
+/**
+ * Wypisuje na standardowe wyjście współczynnik wielomianu z wierzchołka stosu
+ * przy składniku @f$x_0^{e_0} x_1^{e_1} \cdots x_{k-1}^{e_{k-1}}@f$.
+ * Zwraca @p false, gdy na stosie nie ma żadnych wielomianów.
+ * @param[in] s : stos
+ * @param[in] k : liczba wykładników
+ * @param[in] exps : wykładniki @f$e_0, \ldots, e_{k-1}@f$
+ * @return Czy operacja się powiodła?
+ */
+bool Coeff(Stack *s, size_t k, const poly_exp_t exps[]);
+
 #endif //POLYNOMIALS_CALC_OP_H
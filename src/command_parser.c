@@ -10,10 +10,12 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <limits.h>
+#include <stdint.h>
 #include "command_parser.h"
 #include "calc_op.h"
 
-#define ONE_ARG_OP_NUMBER 12 ///< Liczba operacji przyjmujących jeden argument
+#define ONE_ARG_OP_NUMBER 14 ///< Liczba operacji przyjmujących jeden argument
 #define BASE_10 10 ///< Wartość reprezentująca system dziesiętny
 
 /**
@@ -38,10 +40,12 @@ const Operation operations[ONE_ARG_OP_NUMBER] = {
         {.function = Add, .name = "ADD"},
         {.function = Sub, .name = "SUB"},
         {.function = Mul, .name = "MUL"},
+        {.function = MulAdd, .name = "MUL_ADD"},
         {.function = IsEq, .name = "IS_EQ"},
         {.function = Deg, .name = "DEG"},
         {.function = Print, .name = "PRINT"},
-        {.function = StackPop, .name = "POP"}
+        {.function = StackPop, .name = "POP"},
+        {.function = Reorder, .name = "REORDER"}
 };
 
 /**
@@ -59,6 +63,66 @@ const char *DegByCommandName = "DEG_BY";
  */
 const char *AtCommandName = "AT";
 
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref Sum.
+ */
+const char *SumCommandName = "SUM";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref Coeff.
+ */
+const char *CoeffCommandName = "COEFF";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref Subst.
+ */
+const char *SubstCommandName = "SUBST";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref Eval.
+ */
+const char *EvalCommandName = "EVAL";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref Shift.
+ */
+const char *ShiftCommandName = "SHIFT";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref MulMono.
+ */
+const char *MulMonoCommandName = "MUL_MONO";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref Trunc.
+ */
+const char *TruncCommandName = "TRUNC";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref InvSeries.
+ */
+const char *InvSeriesCommandName = "SERIES_INV";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref SqrtSeries.
+ */
+const char *SqrtSeriesCommandName = "SERIES_SQRT";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref ExpSeries.
+ */
+const char *ExpSeriesCommandName = "SERIES_EXP";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref Div.
+ */
+const char *DivCommandName = "DIV";
+
+/**
+ * Nazwa polecenia odpowiadającego operacji @ref Rem.
+ */
+const char *RemCommandName = "REM";
+
 void PrintWrongCommandError(long line_number) {
     fprintf(stderr, "ERROR %ld WRONG COMMAND\n", line_number);
 }
@@ -90,6 +154,99 @@ static void PrintComposeParameterError(long line_number) {
     fprintf(stderr, "ERROR %ld COMPOSE WRONG PARAMETER\n", line_number);
 }
 
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o błędnym parametrze
+ * lub jego braku przy poleceniu @ref Sum.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ */
+static void PrintSumParameterError(long line_number) {
+    fprintf(stderr, "ERROR %ld SUM WRONG PARAMETER\n", line_number);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o błędnym parametrze
+ * lub jego braku przy poleceniu @ref Coeff.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ */
+static void PrintCoeffExponentError(long line_number) {
+    fprintf(stderr, "ERROR %ld COEFF WRONG EXPONENT\n", line_number);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o błędnym parametrze
+ * lub jego braku przy poleceniu @ref Subst.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ */
+static void PrintSubstVariableError(long line_number) {
+    fprintf(stderr, "ERROR %ld SUBST WRONG VARIABLE\n", line_number);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o błędnym parametrze
+ * lub jego braku przy poleceniu @ref Eval.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ */
+static void PrintEvalParameterError(long line_number) {
+    fprintf(stderr, "ERROR %ld EVAL WRONG PARAMETER\n", line_number);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o błędnym parametrze
+ * lub jego braku przy poleceniu @ref Shift.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ */
+static void PrintShiftParameterError(long line_number) {
+    fprintf(stderr, "ERROR %ld SHIFT WRONG PARAMETER\n", line_number);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o błędnym parametrze
+ * lub jego braku przy poleceniu @ref MulMono.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ */
+static void PrintMulMonoParameterError(long line_number) {
+    fprintf(stderr, "ERROR %ld MUL MONO WRONG PARAMETER\n", line_number);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o błędnym parametrze
+ * polecenia @ref Trunc.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ */
+static void PrintTruncDegreeError(long line_number) {
+    fprintf(stderr, "ERROR %ld TRUNC WRONG DEGREE\n", line_number);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o błędnym parametrze
+ * lub jego braku przy jednym z poleceń działań na szeregach.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ * @param[in] name : nazwa polecenia w komunikacie
+ */
+static void PrintSeriesParameterError(long line_number, const char *name) {
+    fprintf(stderr, "ERROR %ld %s WRONG PARAMETER\n", line_number, name);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o tym, że wynik
+ * działania na szeregu nie istnieje.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ * @param[in] name : nazwa polecenia w komunikacie
+ */
+static void PrintSeriesUndefinedError(long line_number, const char *name) {
+    fprintf(stderr, "ERROR %ld %s UNDEFINED\n", line_number, name);
+}
+
+/**
+ * Wypisuje na standardowe wyjście diagnostyczne komunikat o dzielniku, który
+ * nie jest unormowany, przy jednym z poleceń dzielenia.
+ * @param[in] line_number : numer linii, w której wystąpił błąd
+ * @param[in] name : nazwa polecenia w komunikacie
+ */
+static void PrintDivisorError(long line_number, const char *name) {
+    fprintf(stderr, "ERROR %ld %s WRONG DIVISOR\n", line_number, name);
+}
+
 /**
  * Wypisuje na standardowe wyjście diagnostyczne komunikat o niewystarczającej
  * liczbie wielomianów, aby wykonać operację.
@@ -118,6 +275,48 @@ static char *GetArg(char *line, size_t line_size) {
     return NULL;
 }
 
+/**
+ * Zamienia argument polecenia na nieujemną liczbę całkowitą.
+ * @param[in] arg : argument polecenia w postaci ciągu znaków lub NULL
+ * @param[out] value : wartość argumentu
+ * @return Czy argument jest poprawną liczbą z zakresu
+ * od @p 0 do @p 18446744073709551615?
+ */
+static bool ParseUnsignedArg(const char *arg, unsigned long long *value) {
+    if (arg == NULL || !isdigit(arg[0]))
+        return false;
+    char *endptr;
+    *value = strtoull(arg, &endptr, BASE_10);
+    /* Niepoprawny zakres */
+    if (errno == ERANGE) {
+        errno = 0;
+        return false;
+    }
+    /* Argument nie był liczbą */
+    return endptr[0] == '\0';
+}
+
+/**
+ * Zamienia argument polecenia na liczbę całkowitą.
+ * @param[in] arg : argument polecenia w postaci ciągu znaków lub NULL
+ * @param[out] value : wartość argumentu
+ * @return Czy argument jest poprawną liczbą z zakresu
+ * od @p -9223372036854775808 do @p 9223372036854775807?
+ */
+static bool ParseSignedArg(const char *arg, long long *value) {
+    if (arg == NULL || (arg[0] != '-' && !isdigit(arg[0])))
+        return false;
+    char *endptr;
+    *value = strtoll(arg, &endptr, BASE_10);
+    /* Niepoprawny zakres */
+    if (errno == ERANGE) {
+        errno = 0;
+        return false;
+    }
+    /* Argument nie był liczbą */
+    return endptr[0] == '\0';
+}
+
 /**
  * Sprawdza poprawność argumentu polecenia @ref At oraz wykonuje operację z
  * poprawnym argumentem. W przypadku błędnego argumentu lub niewystarczającej
@@ -128,20 +327,8 @@ static char *GetArg(char *line, size_t line_size) {
  * @param line_number : numer linii
  */
 static void ParseAt(Stack *s, char *arg, long line_number) {
-    if (arg == NULL || (arg[0] != '-' && !isdigit(arg[0]))) {
-        PrintAtValueError(line_number);
-        return;
-    }
-    char *endptr;
-    long long value = strtoll(arg, &endptr, 10);
-    /* Błędna wartość argumentu */
-    if (errno == ERANGE) {
-        PrintAtValueError(line_number);
-        errno = 0;
-        return;
-    }
-    /* Argument nie był liczbą */
-    if (endptr[0] != '\0') {
+    long long value;
+    if (!ParseSignedArg(arg, &value)) {
         PrintAtValueError(line_number);
         return;
     }
@@ -161,20 +348,8 @@ static void ParseAt(Stack *s, char *arg, long line_number) {
  * @param[in] line_number : numer linii
  */
 static void ParseDegBy(Stack *s, char *arg, long line_number) {
-    if (arg == NULL || !isdigit(arg[0])) {
-        PrintDegByVariableError(line_number);
-        return;
-    }
-    char *endptr;
-    unsigned long long value = strtoull(arg, &endptr, BASE_10);
-    /* Niepoprawny zakres */
-    if (errno == ERANGE) {
-        PrintDegByVariableError(line_number);
-        errno = 0;
-        return;
-    }
-    /* Argument nie był liczbą */
-    if (endptr[0] != '\0') {
+    unsigned long long value;
+    if (!ParseUnsignedArg(arg, &value)) {
         PrintDegByVariableError(line_number);
         return;
     }
@@ -194,28 +369,285 @@ static void ParseDegBy(Stack *s, char *arg, long line_number) {
  * @param[in] line_number : numer linii
  */
 static void ParseCompose(Stack *s, char *arg, long line_number){
-    if (arg == NULL || !isdigit(arg[0])) {
+    unsigned long long value;
+    if (!ParseUnsignedArg(arg, &value)) {
         PrintComposeParameterError(line_number);
         return;
     }
-    char *endptr;
-    unsigned long long value = strtoull(arg, &endptr, BASE_10);
-    /* Niepoprawny zakres */
-    if (errno == ERANGE) {
-        PrintComposeParameterError(line_number);
-        errno = 0;
+    bool op = Compose(s, value);
+    if (!op)
+        PrintStackUnderflowError(line_number);
+
+}
+
+/**
+ * Sprawdza poprawność argumentu polecenia @ref Sum oraz wykonuje operację z
+ * poprawnym argumentem. W przypadku błędnego argumentu lub niewystarczającej
+ * liczby argumentów na stosie, wypisuje na standardowe wyjście komunikat o
+ * błędzie.
+ * @param[in,out] s : stos
+ * @param[in] arg : argument operacji w postaci ciągu znaków
+ * @param[in] line_number : numer linii
+ */
+static void ParseSum(Stack *s, char *arg, long line_number) {
+    unsigned long long value;
+    if (!ParseUnsignedArg(arg, &value)) {
+        PrintSumParameterError(line_number);
         return;
     }
-    /* Argument nie był liczbą */
-    if (endptr[0] != '\0') {
-        PrintComposeParameterError(line_number);
+    bool op = Sum(s, value);
+    if (!op)
+        PrintStackUnderflowError(line_number);
+}
+
+/**
+ * Sprawdza poprawność argumentu polecenia @ref Subst oraz wykonuje operację z
+ * poprawnym argumentem. W przypadku błędnego argumentu lub niewystarczającej
+ * liczby argumentów na stosie, wypisuje na standardowe wyjście komunikat o
+ * błędzie.
+ * @param[in,out] s : stos
+ * @param[in] arg : argument operacji w postaci ciągu znaków
+ * @param[in] line_number : numer linii
+ */
+static void ParseSubst(Stack *s, char *arg, long line_number) {
+    unsigned long long value;
+    if (!ParseUnsignedArg(arg, &value)) {
+        PrintSubstVariableError(line_number);
         return;
     }
-    bool op = Compose(s, value);
+    bool op = Subst(s, value);
     if (!op)
         PrintStackUnderflowError(line_number);
+}
 
+/**
+ * Sprawdza poprawność argumentu polecenia @ref Coeff, czyli ciągu wykładników
+ * oddzielonych pojedynczymi spacjami, oraz wykonuje operację z poprawnym
+ * argumentem. W przypadku błędnego argumentu lub niewystarczającej liczby
+ * argumentów na stosie, wypisuje na standardowe wyjście komunikat o błędzie.
+ * @param[in,out] s : stos
+ * @param[in] arg : argument operacji w postaci ciągu znaków
+ * @param[in] line_number : numer linii
+ */
+static void ParseCoeff(Stack *s, char *arg, long line_number) {
+    if (arg == NULL) {
+        PrintCoeffExponentError(line_number);
+        return;
+    }
+    size_t k = 1;
+    for (size_t i = 0; arg[i] != '\0'; i++)
+        k += arg[i] == ' ';
+    poly_exp_t *exps = malloc(k * sizeof(poly_exp_t));
+    if (exps == NULL)
+        exit(1);
+
+    char *token = arg;
+    for (size_t i = 0; i < k; i++) {
+        char *end = strchr(token, ' ');
+        if (end != NULL)
+            end[0] = '\0';
+        unsigned long long value;
+        if (!ParseUnsignedArg(token, &value) || value > INT_MAX) {
+            PrintCoeffExponentError(line_number);
+            free(exps);
+            return;
+        }
+        exps[i] = (poly_exp_t) value;
+        if (end != NULL)
+            token = end + 1;
+    }
+
+    bool op = Coeff(s, k, exps);
+    if (!op)
+        PrintStackUnderflowError(line_number);
+    free(exps);
+}
+
+/**
+ * Sprawdza poprawność argumentu polecenia @ref Eval, czyli par indeksów
+ * zmiennych i ich wartości oddzielonych pojedynczymi spacjami, przy czym
+ * indeksy muszą rosnąć, oraz wykonuje operację z poprawnym argumentem.
+ * W przypadku błędnego argumentu lub niewystarczającej liczby argumentów na
+ * stosie, wypisuje na standardowe wyjście komunikat o błędzie.
+ * @param[in,out] s : stos
+ * @param[in] arg : argument operacji w postaci ciągu znaków
+ * @param[in] line_number : numer linii
+ */
+static void ParseEval(Stack *s, char *arg, long line_number) {
+    if (arg == NULL) {
+        PrintEvalParameterError(line_number);
+        return;
+    }
+    size_t tokens = 1;
+    for (size_t i = 0; arg[i] != '\0'; i++)
+        tokens += arg[i] == ' ';
+    if (tokens % 2 != 0) {
+        PrintEvalParameterError(line_number);
+        return;
+    }
+    size_t k = tokens / 2;
+    size_t *vars = malloc(k * sizeof(size_t));
+    poly_coeff_t *values = malloc(k * sizeof(poly_coeff_t));
+    if (vars == NULL || values == NULL)
+        exit(1);
+
+    char *token = arg;
+    bool correct = true;
+    for (size_t i = 0; i < tokens && correct; i++) {
+        char *end = strchr(token, ' ');
+        if (end != NULL)
+            end[0] = '\0';
+        if (i % 2 == 0) {
+            unsigned long long var;
+            correct = ParseUnsignedArg(token, &var) && var <= SIZE_MAX &&
+                      (i == 0 || var > vars[i / 2 - 1]);
+            if (correct)
+                vars[i / 2] = var;
+        }
+        else {
+            long long value;
+            correct = ParseSignedArg(token, &value);
+            if (correct)
+                values[i / 2] = value;
+        }
+        if (end != NULL)
+            token = end + 1;
+    }
+
+    if (!correct)
+        PrintEvalParameterError(line_number);
+    else if (!Eval(s, k, vars, values))
+        PrintStackUnderflowError(line_number);
+    free(vars);
+    free(values);
 }
+
+/**
+ * Sprawdza poprawność argumentów polecenia @ref Shift, czyli indeksu zmiennej
+ * i przesunięcia oddzielonych pojedynczą spacją, oraz wykonuje operację
+ * z poprawnymi argumentami. W przypadku błędnego argumentu lub
+ * niewystarczającej liczby argumentów na stosie, wypisuje na standardowe
+ * wyjście komunikat o błędzie.
+ * @param[in,out] s : stos
+ * @param[in] arg : argument operacji w postaci ciągu znaków
+ * @param[in] line_number : numer linii
+ */
+static void ParseShift(Stack *s, char *arg, long line_number) {
+    char *shift_arg = arg == NULL ? NULL : strchr(arg, ' ');
+    if (shift_arg != NULL)
+        *shift_arg++ = '\0';
+    unsigned long long var;
+    long long shift;
+    if (!ParseUnsignedArg(arg, &var) || var > SIZE_MAX ||
+        !ParseSignedArg(shift_arg, &shift)) {
+        PrintShiftParameterError(line_number);
+        return;
+    }
+    bool op = Shift(s, var, shift);
+    if (!op)
+        PrintStackUnderflowError(line_number);
+}
+
+/**
+ * Sprawdza poprawność argumentów polecenia @ref MulMono, czyli indeksu
+ * zmiennej, wykładnika i współczynnika oddzielonych pojedynczymi spacjami,
+ * oraz wykonuje operację z poprawnymi argumentami. W przypadku błędnego
+ * argumentu lub niewystarczającej liczby argumentów na stosie, wypisuje na
+ * standardowe wyjście komunikat o błędzie.
+ * @param[in,out] s : stos
+ * @param[in] arg : argument operacji w postaci ciągu znaków
+ * @param[in] line_number : numer linii
+ */
+static void ParseMulMono(Stack *s, char *arg, long line_number) {
+    char *exp_arg = arg == NULL ? NULL : strchr(arg, ' ');
+    if (exp_arg != NULL)
+        *exp_arg++ = '\0';
+    char *coeff_arg = exp_arg == NULL ? NULL : strchr(exp_arg, ' ');
+    if (coeff_arg != NULL)
+        *coeff_arg++ = '\0';
+    unsigned long long var, exp;
+    long long coeff;
+    if (!ParseUnsignedArg(arg, &var) || var > SIZE_MAX ||
+        !ParseUnsignedArg(exp_arg, &exp) || exp > INT_MAX ||
+        !ParseSignedArg(coeff_arg, &coeff)) {
+        PrintMulMonoParameterError(line_number);
+        return;
+    }
+    bool op = MulMono(s, var, exp, coeff);
+    if (!op)
+        PrintStackUnderflowError(line_number);
+}
+
+/**
+ * Sprawdza poprawność argumentu polecenia @ref Trunc, czyli ograniczenia
+ * stopnia, oraz wykonuje operację. Polecenie bez argumentu wyłącza
+ * ograniczenie. W przypadku błędnego argumentu wypisuje na standardowe
+ * wyjście komunikat o błędzie.
+ * @param[in,out] s : stos
+ * @param[in] arg : argument operacji w postaci ciągu znaków lub NULL
+ * @param[in] line_number : numer linii
+ */
+static void ParseTrunc(Stack *s, char *arg, long line_number) {
+    if (arg == NULL) {
+        Trunc(s, NO_DEG_BOUND);
+        return;
+    }
+    unsigned long long deg;
+    if (!ParseUnsignedArg(arg, &deg) || deg > INT_MAX) {
+        PrintTruncDegreeError(line_number);
+        return;
+    }
+    Trunc(s, deg);
+}
+
+/**
+ * Sprawdza poprawność argumentów polecenia działania na szeregu, czyli liczby
+ * współczynników i modułu oddzielonych pojedynczą spacją, oraz wykonuje
+ * operację z poprawnymi argumentami. W przypadku błędnego argumentu,
+ * niewystarczającej liczby argumentów na stosie lub gdy wynik nie istnieje,
+ * wypisuje na standardowe wyjście komunikat o błędzie.
+ * @param[in,out] s : stos
+ * @param[in] arg : argument operacji w postaci ciągu znaków
+ * @param[in] line_number : numer linii
+ * @param[in] name : nazwa polecenia w komunikatach o błędzie
+ * @param[in] op : operacja na stosie
+ */
+static void ParseSeries(Stack *s, char *arg, long line_number, const char *name,
+                        bool (*op)(Stack *, poly_exp_t, poly_coeff_t, bool *)) {
+    char *mod_arg = arg == NULL ? NULL : strchr(arg, ' ');
+    if (mod_arg != NULL)
+        *mod_arg++ = '\0';
+    unsigned long long n, m;
+    if (!ParseUnsignedArg(arg, &n) || n > INT_MAX ||
+        !ParseUnsignedArg(mod_arg, &m) || m == 1 || m > INT_MAX) {
+        PrintSeriesParameterError(line_number, name);
+        return;
+    }
+    bool defined;
+    if (!(*op)(s, n, m, &defined))
+        PrintStackUnderflowError(line_number);
+    else if (!defined)
+        PrintSeriesUndefinedError(line_number, name);
+}
+
+/**
+ * Wykonuje jedno z poleceń dzielenia. W przypadku niewystarczającej liczby
+ * argumentów na stosie lub dzielnika, który nie jest unormowany, wypisuje
+ * na standardowe wyjście komunikat o błędzie.
+ * @param[in,out] s : stos
+ * @param[in] line_number : numer linii
+ * @param[in] name : nazwa polecenia w komunikatach o błędzie
+ * @param[in] op : operacja na stosie
+ */
+static void ParseDiv(Stack *s, long line_number, const char *name,
+                     bool (*op)(Stack *, bool *)) {
+    bool monic;
+    if (!(*op)(s, &monic))
+        PrintStackUnderflowError(line_number);
+    else if (!monic)
+        PrintDivisorError(line_number, name);
+}
+
 void ParseCommand(Stack *s, char *line, size_t line_size, long line_number) {
     /* "Odseparowanie" nazwy i argumentu */
     char *arg = GetArg(line, line_size);
@@ -232,6 +664,55 @@ void ParseCommand(Stack *s, char *line, size_t line_size, long line_number) {
         ParseCompose(s, arg, line_number);
         return;
     }
+    else if (strcmp(SumCommandName, line) == 0) {
+        ParseSum(s, arg, line_number);
+        return;
+    }
+    else if (strcmp(CoeffCommandName, line) == 0) {
+        ParseCoeff(s, arg, line_number);
+        return;
+    }
+    else if (strcmp(SubstCommandName, line) == 0) {
+        ParseSubst(s, arg, line_number);
+        return;
+    }
+    else if (strcmp(EvalCommandName, line) == 0) {
+        ParseEval(s, arg, line_number);
+        return;
+    }
+    else if (strcmp(ShiftCommandName, line) == 0) {
+        ParseShift(s, arg, line_number);
+        return;
+    }
+    else if (strcmp(MulMonoCommandName, line) == 0) {
+        ParseMulMono(s, arg, line_number);
+        return;
+    }
+    else if (strcmp(TruncCommandName, line) == 0 &&
+             (arg != NULL || strlen(line) == line_size)) {
+        ParseTrunc(s, arg, line_number);
+        return;
+    }
+    else if (strcmp(InvSeriesCommandName, line) == 0) {
+        ParseSeries(s, arg, line_number, "SERIES INV", InvSeries);
+        return;
+    }
+    else if (strcmp(SqrtSeriesCommandName, line) == 0) {
+        ParseSeries(s, arg, line_number, "SERIES SQRT", SqrtSeries);
+        return;
+    }
+    else if (strcmp(ExpSeriesCommandName, line) == 0) {
+        ParseSeries(s, arg, line_number, "SERIES EXP", ExpSeries);
+        return;
+    }
+    else if (strcmp(DivCommandName, line) == 0 && strlen(line) == line_size) {
+        ParseDiv(s, line_number, "DIV", Div);
+        return;
+    }
+    else if (strcmp(RemCommandName, line) == 0 && strlen(line) == line_size) {
+        ParseDiv(s, line_number, "REM", Rem);
+        return;
+    }
     for (int i = 0; i < ONE_ARG_OP_NUMBER; i++) {
         if (arg != NULL)
             break;
@@ -8,18 +8,60 @@
  * - kiedy tylko można, wielomian postaci @f$c\cdot x^0@f$ jest zamieniany na
  *   wielomian stały @f$c@f$
  * - wielomian @f$0 \cdot x^0@f$ jest rozpatrywany jako współczynnik równy 0
+ * - wielomian, który nie jest współczynnikiem, jest przechowywany w węźle
+ *   @ref PolyNode: po nagłówku ze stopniami wielomianu leży tablica
+ *   wykładników, a za nią równoległa tablica współczynników
+ * - węzeł jest liściem wtedy i tylko wtedy, gdy wszystkie jego współczynniki
+ *   są liczbami; liść przechowuje je jako tablicę liczb
+ * - wielomian postaci @f$c\cdot x^n@f$, gdzie @f$c \neq 0@f$ jest liczbą,
+ *   a @f$n > 0@f$, jest zawsze przechowywany bez węzła (patrz
+ *   @ref PolyInline)
  *
  * @author Katarzyna Mielnik <km429567@students.mimuw.edu.pl>
  * @date 2.05.2021
  */
 
+#include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 #include "poly.h"
 
 /** Liczba o 1 mniejsza od indeksu pierwszej zmiennej wielomianu - służy do
  *  wywołania @ref ComposeHelper */
 #define COMPOSE_STARTING_INDEX -1
 
+/** Liczba pierwszych zmiennych wielomianu, dla których stopień względem
+ *  zmiennej jest zapamiętywany w nagłówku węzła. */
+#define DEG_CACHE_LEVELS 3
+
+/** Wyrównanie (w bajtach) tablicy współczynników w węźle. */
+#define NODE_COEFFS_ALIGN 8
+
+#ifdef POLY_COMPACT_MONO
+/** Bit pola @p size oznaczający jednomian przechowywany bez węzła. */
+#define INLINE_FLAG ((uint32_t) 1 << 31)
+#endif
+
+/**
+ * Węzeł wielomianu, który nie jest współczynnikiem. Wykładniki i współczynniki
+ * jednomianów są przechowywane w dwóch równoległych tablicach: tablica
+ * wykładników @p exps leży bezpośrednio za nagłówkiem, a tablica
+ * współczynników - za nią (patrz @ref NodeCoeffs i @ref LeafCoeffs). Dzięki
+ * temu scalanie i porównywanie wykładników przegląda ciągły obszar pamięci,
+ * w którym nie ma współczynników.
+ * Współczynniki liścia są liczbami typu @ref poly_coeff_t, a pozostałych
+ * węzłów - wielomianami.
+ * Stopnie zapisane w nagłówku są wyliczane przy tworzeniu wielomianu, dzięki
+ * czemu @ref PolyDeg i @ref PolyDegBy nie muszą przechodzić całego drzewa.
+ */
+typedef struct PolyNode {
+    poly_exp_t deg; ///< stopień wielomianu
+    /** stopnie wielomianu ze względu na zmienne @f$x_0, x_1, \ldots@f$ */
+    poly_exp_t deg_by[DEG_CACHE_LEVELS];
+    bool leaf; ///< czy węzeł jest liściem
+    poly_exp_t exps[]; ///< wykładniki jednomianów
+} PolyNode;
+
 /**
  * Zwraca większy z dwóch wykładników.
  * @param[in] a : wykładnik
@@ -37,538 +79,3930 @@ Mono *SafeMonoMalloc(size_t size) {
 }
 
 /**
- * Sprawdza, czy wielomian jest współczynnkiem zagłębionym w struktury
- * wielomianów stopnia 0.
+ * Tworzy wielomian @f$c\cdot x^n@f$ przechowywany bez węzła. Współczynnik
+ * zajmuje pole @p coeff, a wykładnik jest zakodowany w polu, które w innych
+ * wielomianach wskazuje na węzeł (lub w polu @p size w zwartym układzie
+ * pamięci). Taki wielomian nie zajmuje pamięci na stercie.
+ * @param[in] c : niezerowy współczynnik
+ * @param[in] n : dodatni wykładnik
+ * @return @f$c\cdot x^n@f$
+ */
+static Poly PolyInline(poly_coeff_t c, poly_exp_t n) {
+    assert(c != 0 && n > 0);
+#ifdef POLY_COMPACT_MONO
+    return (Poly) {.coeff = c, .size = INLINE_FLAG | (uint32_t) n};
+#else
+    return (Poly) {.coeff = c, .node = (struct PolyNode *) (((uintptr_t) n << 1) | 1)};
+#endif
+}
+
+/**
+ * Sprawdza, czy wielomian jest jednomianem przechowywanym bez węzła.
  * @param[in] p : wielomian
- * @return Czy wielomian ma postać @f$x_0^0(x_1^0(\ldots(c)))@f$?
+ * @return Czy wielomian został utworzony funkcją @ref PolyInline?
  */
-static bool PolyIsNestedCoeff(const Poly *p) {
-    if (PolyIsCoeff(p))
-        return true;
+static bool PolyIsInline(const Poly *p) {
+#ifdef POLY_COMPACT_MONO
+    return (p->size & INLINE_FLAG) != 0;
+#else
+    return ((uintptr_t) p->node & 1) != 0;
+#endif
+}
 
-    if (p->size == 1 && p->arr[0].exp == 0 && PolyIsNestedCoeff(&p->arr[0].p))
-        return true;
-    else return false;
+/**
+ * Daje wykładnik jednomianu przechowywanego bez węzła.
+ * @param[in] p : wielomian utworzony funkcją @ref PolyInline
+ * @return wykładnik
+ */
+static poly_exp_t InlineExp(const Poly *p) {
+    assert(PolyIsInline(p));
+#ifdef POLY_COMPACT_MONO
+    return (poly_exp_t) (p->size & ~INLINE_FLAG);
+#else
+    return (poly_exp_t) ((uintptr_t) p->node >> 1);
+#endif
 }
 
 /**
- * Tworzy wielomian stały na podstawie wielomianu z zagłębionym współczynnkiem.
- * @param[in] p : wielomian postaci @f$x_0^0(x_1^0(\ldots(c)))@f$
- * @return wielomian będący współczynnikiem @f$c@f$
+ * Tworzy wielomian @f$c\cdot x^n@f$ o liczbowym współczynniku bez alokowania
+ * pamięci.
+ * @param[in] c : współczynnik
+ * @param[in] n : wykładnik
+ * @return @f$c\cdot x^n@f$
  */
-static Poly PolyToCoeff(const Poly *p) {
-    assert(PolyIsNestedCoeff(p));
-    if (p->arr == NULL)
-        return PolyFromCoeff(p->coeff);
-    else
-        return PolyToCoeff(&p->arr[0].p);
+static Poly PolyFromTerm(poly_coeff_t c, poly_exp_t n) {
+    if (c == 0 || n == 0)
+        return PolyFromCoeff(c);
+    return PolyInline(c, n);
 }
 
 /**
- * Tworzy wielomian na podstawie tablicy wielomianów. Jeśli wielomian jest
- * zagłębionym jednomianem, upraszcza go. Przejmuje na własność tablicę
- * @p monos i jej zawartość.
- * @param[in] monos : tablica jednomianów
- * @param array_size : rozmiar tablicy jednomianów
- * @return wielomian stworzony na podstawie tablicy jednomianów
+ * Daje przesunięcie tablicy współczynników względem początku węzła.
+ * @param[in] capacity : liczba jednomianów, na którą zaalokowano węzeł
+ * @return przesunięcie w bajtach
  */
-static Poly PolyFromArray(Mono *monos, size_t array_size) {
-    Poly poly = (Poly) {.arr = monos, .size = array_size};
-    if (PolyIsNestedCoeff(&poly)) {
-        Poly new_poly = PolyToCoeff(&poly);
-        PolyDestroy(&poly);
-        return new_poly;
-    }
-    return poly;
+static size_t NodeCoeffsOffset(size_t capacity) {
+    size_t offset = sizeof(PolyNode) + capacity * sizeof(poly_exp_t);
+    return (offset + NODE_COEFFS_ALIGN - 1) / NODE_COEFFS_ALIGN * NODE_COEFFS_ALIGN;
 }
 
-void PolyDestroy(Poly *p) {
-    if (!PolyIsCoeff(p)) {
-        for (size_t i = 0; i < p->size; i++) {
-            MonoDestroy(&p->arr[i]);
-        }
-        free(p->arr);
-    }
+/**
+ * Daje rozmiar węzła, który nie jest liściem.
+ * @param[in] capacity : liczba jednomianów węzła
+ * @return rozmiar węzła w bajtach
+ */
+static size_t NodeBytes(size_t capacity) {
+    return NodeCoeffsOffset(capacity) + capacity * sizeof(Poly);
 }
 
-Poly PolyClone(const Poly *p) {
-    if (PolyIsCoeff(p))
-        return PolyFromCoeff(p->coeff);
+/**
+ * Daje rozmiar liścia.
+ * @param[in] capacity : liczba jednomianów liścia
+ * @return rozmiar liścia w bajtach
+ */
+static size_t LeafBytes(size_t capacity) {
+    return NodeCoeffsOffset(capacity) + capacity * sizeof(poly_coeff_t);
+}
 
-    Mono *new_mono_array = SafeMonoMalloc(p->size);
-    for (size_t i = 0; i < p->size; i++) {
-        new_mono_array[i] = MonoClone(&p->arr[i]);
-    }
-    return (Poly) {.arr = new_mono_array, .size = p->size};
+/**
+ * Daje tablicę współczynników węzła, który nie jest liściem.
+ * @param[in] node : węzeł
+ * @param[in] capacity : liczba jednomianów, na którą zaalokowano węzeł
+ * @return tablica współczynników
+ */
+static Poly *NodeCoeffs(const PolyNode *node, size_t capacity) {
+    return (Poly *) ((char *) node + NodeCoeffsOffset(capacity));
 }
 
 /**
- * Komparator wykładników jednomianów.
+ * Daje tablicę współczynników liścia.
+ * @param[in] node : liść
+ * @param[in] capacity : liczba jednomianów, na którą zaalokowano liść
+ * @return tablica współczynników
  */
-static int MonoExpCmp(const void *a, const void *b) {
-    Mono mono_a = *(Mono *) a;
-    Mono mono_b = *(Mono *) b;
-    if (mono_a.exp < mono_b.exp)
-        return -1;
-    if (mono_a.exp == mono_b.exp)
-        return 0;
-    return 1;
+static poly_coeff_t *LeafCoeffs(const PolyNode *node, size_t capacity) {
+    return (poly_coeff_t *) ((char *) node + NodeCoeffsOffset(capacity));
 }
 
 /**
- * Dodaje jednomiany z dwóch tablic.
- * @param[in] p : tablica jednomianów
- * @param[in] q : tablica jednomianów
- * @param[in] p_size : rozmiar tablicy @p p
- * @param[in] q_size : rozmiar tablicy @p q
- * @param[in,out] array_size : wartość, do której zostaje wpisana liczba
- * różnych jednomianów w tablicy wynikowej
- * @return tablica jednomianów
+ * Alokuje węzeł, który nie jest liściem, na @p capacity jednomianów.
+ * Węzeł należy zwolnić funkcją free.
+ * @param[in] capacity : liczba jednomianów
+ * @return niewypełniony węzeł
  */
-static Mono *AddMonoArrays(const Mono *p, const Mono *q, size_t p_size,
-                           size_t q_size, size_t *array_size) {
-    assert(p_size + q_size != 0);
-    Mono *array = SafeMonoMalloc(p_size + q_size);
-    size_t index = 0, p_i = 0, q_i = 0;
-    while (p_i != p_size || q_i != q_size) {
-        /* Wpisuje kopię wielomianu o mniejszym wykładniku */
-        if (p_i == p_size || (q_i != q_size && p[p_i].exp > q[q_i].exp)) {
-            if (!PolyIsZero(&q[q_i].p))
-                array[index++] = MonoClone(&q[q_i]);
-            q_i++;
-        }
-        else if (q_i == q_size || (p_i != p_size && p[p_i].exp < q[q_i].exp)) {
-            if (!PolyIsZero(&p[p_i].p))
-                array[index++] = MonoClone(&p[p_i]);
-            p_i++;
-        }
-            /* Gdy w obu tablicach są jednomiany o tym samym wykładniku, w tablicy
-             * zostaje zapisana ich suma (o ile nie jest zerem) */
-        else if (p[p_i].exp == q[q_i].exp) {
-            Mono new_mono = (Mono) {.exp = p[p_i].exp, .p = PolyAdd(&p[p_i].p, &q[q_i].p)};
-            if (!PolyIsZero(&new_mono.p))
-                array[index++] = new_mono;
-            p_i++;
-            q_i++;
-        }
-    }
-    *array_size = index;
-    return array;
+static PolyNode *NodeMalloc(size_t capacity) {
+    PolyNode *node = malloc(NodeBytes(capacity));
+    if (node == NULL) exit(1);
+    node->leaf = false;
+    return node;
 }
 
 /**
- * @brief Dodaje wielomian stały do tablicy jednomianów.
- * Przekształca współczynnik @p c w jednomian oraz dodaje go do tablicy
- * jednomianów @p p.
- * @param[in] p : tablica jednomianów
- * @param[in] p_size : rozmiar tablicy @p p
- * @param[in] c : wielomian stały
- * @param[in,out] new_array_size : rozmiar wynikowej tablicy
- * @return tablica zawierająca elementy @p p oraz @f$c*x^0@f$
+ * Alokuje liść na @p capacity jednomianów. Liść należy zwolnić funkcją free.
+ * @param[in] capacity : liczba jednomianów
+ * @return niewypełniony liść
  */
-static Mono *MonosAddCoeff(const Mono *p, size_t p_size, const Poly *c, size_t *new_array_size) {
-    assert(PolyIsCoeff(c));
-    assert(p != NULL);
-    Mono temp = MonoFromPoly(c, 0);
-    return AddMonoArrays(&temp, p, 1, p_size, new_array_size);
+static PolyNode *LeafMalloc(size_t capacity) {
+    PolyNode *node = malloc(LeafBytes(capacity));
+    if (node == NULL) exit(1);
+    node->leaf = true;
+    return node;
 }
 
+/**
+ * Sprawdza, czy wielomian jest przechowywany w węźle.
+ * @param[in] p : wielomian
+ * @return Czy wielomian nie jest współczynnikiem ani jednomianem
+ * przechowywanym bez węzła?
+ */
+static bool PolyHasNode(const Poly *p) {
+    return !PolyIsCoeff(p) && !PolyIsInline(p);
+}
 
-Poly PolyAdd(const Poly *p, const Poly *q) {
-    if (PolyIsCoeff(p) && PolyIsCoeff(q))
-        return PolyFromCoeff(p->coeff + q->coeff);
+/**
+ * Sprawdza, czy wielomian jest przechowywany w liściu.
+ * @param[in] p : wielomian
+ * @return Czy wielomian jest przechowywany w węźle, którego współczynniki są
+ * liczbami?
+ */
+static bool PolyIsLeaf(const Poly *p) {
+    return PolyHasNode(p) && p->node->leaf;
+}
 
-    size_t new_array_size;
-    Mono *new_array;
+/**
+ * Sprawdza, czy wielomian jest przechowywany w węźle, który nie jest liściem.
+ * Tylko w takie wielomiany trzeba schodzić przy przechodzeniu drzewa.
+ * @param[in] p : wielomian
+ * @return Czy wielomian ma współczynnik, który nie jest liczbą?
+ */
+static bool PolyIsInner(const Poly *p) {
+    return PolyHasNode(p) && !p->node->leaf;
+}
 
-    if (!PolyIsCoeff(p) && !PolyIsCoeff(q))
-        new_array = AddMonoArrays(p->arr, q->arr, p->size, q->size, &new_array_size);
-    else if (PolyIsCoeff(p) && !PolyIsCoeff(q))
-        new_array = MonosAddCoeff(q->arr, q->size, p, &new_array_size);
-    else
-        new_array = MonosAddCoeff(p->arr, p->size, q, &new_array_size);
+/**
+ * Daje tablicę współczynników wielomianu przechowywanego w węźle, który nie
+ * jest liściem.
+ * @param[in] p : wielomian
+ * @return tablica współczynników
+ */
+static Poly *PolyCoeffs(const Poly *p) {
+    assert(PolyIsInner(p));
+    return NodeCoeffs(p->node, p->size);
+}
 
-    /* Jeśli suma wszystkich wykładników jest zerem */
-    if (new_array_size == 0) {
-        free(new_array);
-        return PolyZero();
+/**
+ * Daje tablicę współczynników wielomianu przechowywanego w liściu.
+ * @param[in] p : wielomian będący liściem
+ * @return tablica współczynników
+ */
+static poly_coeff_t *PolyLeafCoeffs(const Poly *p) {
+    assert(PolyIsLeaf(p));
+    return LeafCoeffs(p->node, p->size);
+}
+
+/**
+ * Widok jednomianów wielomianu, niezależny od tego, czy wielomian jest
+ * przechowywany w węźle. Niezerowy współczynnik @f$c@f$ jest widziany jako
+ * jednomian @f$c\cdot x^0@f$, a zero - jako pusty wielomian. Dla wielomianu
+ * bez węzła tablice wskazują na pola widoku, więc widoku nie wolno kopiować.
+ */
+typedef struct {
+    const poly_exp_t *exps; ///< wykładniki jednomianów
+    /** współczynniki będące wielomianami lub NULL, jeśli są liczbami */
+    const Poly *coeffs;
+    /** współczynniki będące liczbami lub NULL, jeśli są wielomianami */
+    const poly_coeff_t *values;
+    size_t size; ///< liczba jednomianów
+    poly_exp_t inline_exp; ///< wykładnik jednomianu przechowywanego bez węzła
+    poly_coeff_t inline_coeff; ///< współczynnik jednomianu przechowywanego bez węzła
+} MonosView;
+
+/**
+ * Tworzy widok jednomianów wielomianu.
+ * @param[out] v : widok
+ * @param[in] p : wielomian
+ */
+static void MonosViewInit(MonosView *v, const Poly *p) {
+    if (!PolyHasNode(p)) {
+        v->inline_exp = PolyIsCoeff(p) ? 0 : InlineExp(p);
+        v->inline_coeff = p->coeff;
+        v->exps = &v->inline_exp;
+        v->coeffs = NULL;
+        v->values = &v->inline_coeff;
+        v->size = PolyIsZero(p) ? 0 : 1;
+        return;
+    }
+
+    v->exps = p->node->exps;
+    v->size = p->size;
+    if (p->node->leaf) {
+        v->coeffs = NULL;
+        v->values = LeafCoeffs(p->node, p->size);
     }
-    /* Uproszczenie wielomianu */
-    Poly new_poly = (Poly) {.arr = new_array, .size = new_array_size};
-    if (PolyIsNestedCoeff(&new_poly)) {
-        Poly simplified_poly = PolyToCoeff(&new_poly);
-        PolyDestroy(&new_poly);
-        return simplified_poly;
+    else {
+        v->coeffs = NodeCoeffs(p->node, p->size);
+        v->values = NULL;
     }
-    else return new_poly;
 }
 
-Poly PolySub(const Poly *p, const Poly *q) {
-    Poly q_neg = PolyNeg(q);
-    Poly result = PolyAdd(p, &q_neg);
-    PolyDestroy(&q_neg);
-    return result;
+/**
+ * Daje współczynnik jednomianu o indeksie @p i z widoku. Zwrócony wielomian
+ * należy do wielomianu, z którego utworzono widok - nie wolno go usuwać.
+ * @param[in] v : widok
+ * @param[in] i : indeks jednomianu
+ * @return współczynnik jednomianu
+ */
+static Poly MonosViewCoeff(const MonosView *v, size_t i) {
+    assert(i < v->size);
+    if (v->values != NULL)
+        return PolyFromCoeff(v->values[i]);
+    return v->coeffs[i];
 }
 
 /**
- * Tworzy kopię tablicy jednomianów bez jednomianów o współczynnikach równych zero.
- * @param[in] count : rozmiar tablicy @p monos
- * @param[in] monos : tablica jednomianów
- * @param[in,out] copy_size : liczba jednomianów wpisanych do nowej tablicy
- * @return kopia tablicy @p monos, ale bez jednomianów o zerowych współczynnikach
+ * Daje stopień wielomianu ze względu na jedną z pierwszych
+ * @ref DEG_CACHE_LEVELS zmiennych bez przechodzenia drzewa.
+ * @param[in] p : wielomian
+ * @param[in] var_idx : indeks zmiennej mniejszy od @ref DEG_CACHE_LEVELS
+ * @return stopień wielomianu ze względu na zmienną @p var_idx
  */
-static Mono *CopyMonosArray(size_t count, const Mono *monos, size_t *copy_size) {
-    assert(count != 0);
-    Mono *array = SafeMonoMalloc(count);
-    size_t last_index = 0;
-    for (size_t i = 0; i < count; i++) {
-        if (!PolyIsZero(&monos[i].p))
-            array[last_index++] = monos[i];
-        /* Z założeń, monos[i].p nie jest "zagłębionym" zerem, więc nie wywołuje PolyDestroy */
-    }
-    *copy_size = last_index;
-    return array;
+static poly_exp_t PolyCachedDegBy(const Poly *p, size_t var_idx) {
+    assert(var_idx < DEG_CACHE_LEVELS);
+    if (PolyIsCoeff(p))
+        return PolyIsZero(p) ? -1 : 0;
+    if (PolyIsInline(p))
+        return var_idx == 0 ? InlineExp(p) : 0;
+    return p->node->deg_by[var_idx];
 }
 
 /**
- * Upraszcza tablicę @p monos tak, aby wykładniki jednomianów były parami różne.
- * Przejmuje zawartość @p monos na własność. Zmienna @p monos_owner powinna być
- * ustawiona na @p true, jeśli funkcja przejumje na własność wielomiany z tablicy
- * @p monos lub na @p false w przeciwnym przypadku.
- * @param[in,out] monos : tablica jednomianów
- * @param[in] size : rozmiar tablicy @p monos
- * @param[in,out] new_size : rozmiar tablicy wynikowej
- * @param[in] monos_owner : informacja o tym, czy funkcja przejmuje na własność zawartość @p monos
- * @return tablica jednomianów posortowana rosnąco po wykładnikach
+ * Wylicza nagłówek węzła na podstawie wykładników i nagłówków współczynników.
+ * @param[in,out] node : węzeł
+ * @param[in] size : liczba jednomianów węzła
  */
-static Mono *SimplifyMonos(Mono *monos, size_t size, size_t *new_size, const bool monos_owner) {
-    assert(size != 0);
-    size_t index = 0;
-    bool last_mono_owner = monos_owner;
-    Mono *array = SafeMonoMalloc(size);
-    qsort(monos, size, sizeof(Mono), MonoExpCmp);
-    array[index] = monos[0];
-    for (size_t i = 1; i < size; i++) {
-        if (array[index].exp == monos[i].exp && !PolyIsZero(&monos[i].p)) {
-            Poly curr_poly = array[index].p;
-            array[index].p = PolyAdd(&curr_poly, &monos[i].p);
-            if (monos_owner)
-                MonoDestroy(&monos[i]);
-            if (last_mono_owner)
-                PolyDestroy(&curr_poly);
-            last_mono_owner = true;
-        }
-        else {
-            /* Jeśli ostatnio dodany jednomian ma zerowy współczynnik, nadpisuje
-             * go następnym jednomianem */
-            if (!PolyIsZero(&array[index].p))
-                index++;
-            array[index] = monos[i];
-            last_mono_owner = monos_owner;
-        }
+static void NodeUpdateHeader(PolyNode *node, size_t size) {
+    node->deg_by[0] = node->exps[size - 1];
+    /* Współczynniki liścia są niezerowymi liczbami */
+    if (node->leaf) {
+        node->deg = node->deg_by[0];
+        for (size_t level = 1; level < DEG_CACHE_LEVELS; level++)
+            node->deg_by[level] = 0;
+        return;
+    }
+
+    const Poly *coeffs = NodeCoeffs(node, size);
+    node->deg = -1;
+    for (size_t level = 1; level < DEG_CACHE_LEVELS; level++)
+        node->deg_by[level] = -1;
+    for (size_t i = 0; i < size; i++) {
+        node->deg = MaxExp(node->deg, node->exps[i] + PolyDeg(&coeffs[i]));
+        for (size_t level = 1; level < DEG_CACHE_LEVELS; level++)
+            node->deg_by[level] = MaxExp(node->deg_by[level],
+                                         PolyCachedDegBy(&coeffs[i], level - 1));
     }
-    /* Sprawdza, czy ostatni jednomian ma zerowy współczynnik */
-    if (PolyIsZero(&array[index].p))
-        index--;
-    *new_size = index + 1;
-    return array;
 }
 
-Poly PolyOwnMonos(size_t count, Mono *monos) {
-    if (count == 0)
-        return PolyZero();
+/**
+ * Zmniejsza zaalokowany obszar węzła, jeśli zostało w nim dużo wolnego
+ * miejsca. Zmniejszanie węzła o niewiele rzadko się opłaca, bo zostawia
+ * w stercie małe wolne fragmenty.
+ * @param[in] node : węzeł
+ * @param[in] allocated : rozmiar zaalokowanego obszaru w bajtach
+ * @param[in] needed : rozmiar węzła w bajtach
+ * @return węzeł, być może przeniesiony w inne miejsce
+ */
+static PolyNode *NodeShrink(PolyNode *node, size_t allocated, size_t needed) {
+    if (3 * needed < 2 * allocated) {
+        node = realloc(node, needed);
+        if (node == NULL) exit(1);
+    }
+    return node;
+}
 
-    Mono *new;
-    size_t new_size = 0;
-    new = SimplifyMonos(monos, count, &new_size, true);
-    free(monos);
-    /* Gdy wszystko uprościło się do zera */
-    if (new_size == 0) {
-        free(new);
-        return PolyZero();
+/**
+ * Tworzy wielomian z liścia zaalokowanego na @p capacity jednomianów, w którym
+ * wypełniono @p size pierwszych wykładników i niezerowych współczynników.
+ * Przesuwa współczynniki na właściwe miejsce i wylicza nagłówek. Wielomian
+ * o co najwyżej jednym jednomianie zamienia na współczynnik lub jednomian
+ * przechowywany bez węzła. Przejmuje liść na własność.
+ * @param[in] node : liść
+ * @param[in] capacity : liczba jednomianów, na którą zaalokowano liść
+ * @param[in] size : liczba wypełnionych jednomianów
+ * @return wielomian
+ */
+static Poly PolyFromLeaf(PolyNode *node, size_t capacity, size_t size) {
+    assert(size <= capacity && node->leaf);
+    poly_coeff_t *coeffs = LeafCoeffs(node, capacity);
+    if (size <= 1) {
+        Poly result = size == 0 ? PolyZero() : PolyFromTerm(coeffs[0], node->exps[0]);
+        free(node);
+        return result;
     }
 
-    return PolyFromArray(new, new_size);
+    if (size < capacity) {
+        memmove(LeafCoeffs(node, size), coeffs, size * sizeof(poly_coeff_t));
+        node = NodeShrink(node, LeafBytes(capacity), LeafBytes(size));
+    }
+    NodeUpdateHeader(node, size);
+#ifdef POLY_COMPACT_MONO
+    assert(size < INLINE_FLAG);
+#endif
+    return (Poly) {.node = node, .size = size};
 }
 
-Poly PolyAddMonos(size_t count, const Mono monos[]) {
-    if (count == 0)
-        return PolyZero();
+/**
+ * Tworzy wielomian z węzła zaalokowanego funkcją @ref NodeMalloc na
+ * @p capacity jednomianów, w którym wypełniono @p size pierwszych wykładników
+ * i niezerowych współczynników. Jeśli wszystkie współczynniki są liczbami,
+ * zamienia węzeł w liść (patrz @ref PolyFromLeaf). Przesuwa współczynniki na
+ * właściwe miejsce i wylicza nagłówek. Przejmuje węzeł na własność.
+ * @param[in] node : węzeł
+ * @param[in] capacity : liczba jednomianów, na którą zaalokowano węzeł
+ * @param[in] size : liczba wypełnionych jednomianów
+ * @return wielomian
+ */
+static Poly PolyFromNode(PolyNode *node, size_t capacity, size_t size) {
+    assert(size <= capacity && !node->leaf);
+    Poly *coeffs = NodeCoeffs(node, capacity);
+    bool leaf = true;
+    for (size_t i = 0; i < size && leaf; i++)
+        leaf = PolyIsCoeff(&coeffs[i]);
 
-    size_t copy_size = 0;
-    Mono *monos_copy = CopyMonosArray(count, monos, &copy_size);
-    /* Gdy w monos[] wszystko było zerami */
-    if (copy_size == 0) {
-        free(monos_copy);
-        return PolyZero();
+    if (leaf) {
+        /* Liczba trafia na miejsce zajmowane przez współczynniki o indeksach
+         * nie większych niż jej własny */
+        poly_coeff_t *values = LeafCoeffs(node, capacity);
+        for (size_t i = 0; i < size; i++) {
+            poly_coeff_t c = coeffs[i].coeff;
+            values[i] = c;
+        }
+        memmove(LeafCoeffs(node, size), values, size * sizeof(poly_coeff_t));
+        node->leaf = true;
+        if (size > 1)
+            node = NodeShrink(node, NodeBytes(capacity), LeafBytes(size));
+        return PolyFromLeaf(node, size, size);
     }
 
-    return PolyOwnMonos(copy_size, monos_copy);
+    if (size < capacity) {
+        memmove(NodeCoeffs(node, size), coeffs, size * sizeof(Poly));
+        node = NodeShrink(node, NodeBytes(capacity), NodeBytes(size));
+    }
+    NodeUpdateHeader(node, size);
+#ifdef POLY_COMPACT_MONO
+    assert(size < INLINE_FLAG);
+#endif
+    return (Poly) {.node = node, .size = size};
 }
 
-Poly PolyCloneMonos(size_t count, const Mono monos[]) {
-    if (count == 0 || monos == NULL)
-        return PolyZero();
+/** Liczba ramek stosu @ref WalkStack mieszczących się bez alokacji na stercie. */
+#define WALK_STACK_INITIAL_SIZE 32
 
-    size_t copy_size = 0;
-    Mono *copy = CopyMonosArray(count, monos, &copy_size);
-    if (copy_size == 0) {
-        free(copy);
-        return PolyZero();
+/**
+ * Ramka stosu używanego przy nierekurencyjnym przechodzeniu wielomianów.
+ * Odpowiada jednemu węzłowi, który nie jest liściem i którego współczynniki
+ * są kolejno przeglądane.
+ */
+typedef struct {
+    PolyNode *node; ///< przeglądany węzeł
+    Poly *coeffs; ///< tablica współczynników węzła @p node
+    Poly *other; ///< tablica odpowiadająca @p coeffs w drugim wielomianie
+    size_t size; ///< liczba jednomianów węzła @p node
+    size_t index; ///< indeks następnego współczynnika do przejrzenia
+} WalkFrame;
+
+/**
+ * Stos ramek zastępujący rekurencję przy przechodzeniu wielomianów, dzięki
+ * czemu głębokość wielomianu nie jest ograniczona rozmiarem stosu wywołań.
+ * Dopóki ramki mieszczą się w tablicy @p initial, stos nie alokuje pamięci.
+ * Na stos trafiają tylko węzły, które nie są liśćmi, bo pozostałe wielomiany
+ * nie mają współczynników, w które trzeba zejść.
+ */
+typedef struct {
+    WalkFrame *frames; ///< tablica ramek
+    size_t size; ///< liczba ramek na stosie
+    size_t arr_size; ///< rozmiar tablicy @p frames
+    WalkFrame initial[WALK_STACK_INITIAL_SIZE]; ///< początkowa tablica ramek
+} WalkStack;
+
+/**
+ * Inicjuje pusty stos ramek.
+ * @param[out] s : stos
+ */
+static void WalkStackInit(WalkStack *s) {
+    s->frames = s->initial;
+    s->size = 0;
+    s->arr_size = WALK_STACK_INITIAL_SIZE;
+}
+
+/**
+ * Zwalnia pamięć zajmowaną przez stos ramek.
+ * @param[in,out] s : stos
+ */
+static void WalkStackFree(WalkStack *s) {
+    if (s->frames != s->initial)
+        free(s->frames);
+}
+
+/**
+ * Wstawia na stos ramkę dla węzła wielomianu @p p.
+ * Może unieważnić wskaźniki na ramki stosu.
+ * @param[in,out] s : stos
+ * @param[in] p : wielomian przechowywany w węźle, który nie jest liściem
+ * @param[in] other : tablica współczynników odpowiadająca @p p w drugim
+ * wielomianie
+ */
+static void WalkStackPush(WalkStack *s, const Poly *p, Poly *other) {
+    if (s->size == s->arr_size) {
+        s->arr_size *= 2;
+        WalkFrame *frames;
+        if (s->frames == s->initial) {
+            frames = malloc(s->arr_size * sizeof(WalkFrame));
+            if (frames != NULL)
+                for (size_t i = 0; i < s->size; i++)
+                    frames[i] = s->initial[i];
+        }
+        else
+            frames = realloc(s->frames, s->arr_size * sizeof(WalkFrame));
+        if (frames == NULL)
+            exit(1);
+        s->frames = frames;
     }
-    size_t new_size = 0;
-    Mono *new = SimplifyMonos(copy, copy_size, &new_size, false);
-    if (new_size == 0) {
-        free(new);
-        return PolyZero();
+    s->frames[s->size++] = (WalkFrame) {.node = p->node, .coeffs = PolyCoeffs(p),
+                                        .other = other, .size = p->size,
+                                        .index = 0};
+}
+
+void PolyDestroy(Poly *p) {
+    if (!PolyHasNode(p))
+        return;
+    if (PolyIsLeaf(p)) {
+        free(p->node);
+        return;
     }
 
-    return PolyFromArray(new, new_size);
+    WalkStack stack;
+    WalkStackInit(&stack);
+    WalkStackPush(&stack, p, NULL);
+    while (stack.size != 0) {
+        WalkFrame *top = &stack.frames[stack.size - 1];
+        /* Pomija wielomiany bez węzłów i zwalnia liście aż do pierwszego
+         * wielomianu, w który trzeba zejść */
+        while (top->index != top->size) {
+            Poly *coeff = &top->coeffs[top->index];
+            if (PolyIsLeaf(coeff))
+                free(coeff->node);
+            else if (PolyIsInner(coeff))
+                break;
+            top->index++;
+        }
+        if (top->index == top->size) {
+            free(top->node);
+            stack.size--;
+        }
+        else
+            WalkStackPush(&stack, &top->coeffs[top->index++], NULL);
+    }
+    WalkStackFree(&stack);
 }
 
-poly_exp_t PolyDegBy(const Poly *p, size_t var_idx) {
-    if (PolyIsZero(p))
-        return -1;
-    if (PolyIsCoeff(p))
-        return 0;
-    else {
-        poly_exp_t max_deg = -1;
-        for (size_t i = 0; i < p->size; i++) {
-            Mono curr_mono = p->arr[i];
-            poly_exp_t curr_deg;
-            if (var_idx != 0)
-                curr_deg = PolyDegBy(&(curr_mono.p), var_idx - 1);
-            else
-                curr_deg = curr_mono.exp;
+/**
+ * Kopiuje węzeł wielomianu @p p wraz z nagłówkiem. Współczynniki kopii, które
+ * nie są liczbami, współdzielą węzły z @p p i trzeba je zastąpić kopiami.
+ * @param[in] p : wielomian przechowywany w węźle
+ * @return wielomian z płytką kopią węzła
+ */
+static Poly PolyCopyNode(const Poly *p) {
+    size_t bytes = PolyIsLeaf(p) ? LeafBytes(p->size) : NodeBytes(p->size);
+    PolyNode *node = malloc(bytes);
+    if (node == NULL) exit(1);
+    memcpy(node, p->node, bytes);
+    return (Poly) {.node = node, .size = p->size};
+}
 
-            max_deg = MaxExp(max_deg, curr_deg);
+Poly PolyClone(const Poly *p) {
+    if (!PolyHasNode(p))
+        return *p;
+    if (PolyIsLeaf(p))
+        return PolyCopyNode(p);
+
+    Poly new_poly = PolyCopyNode(p);
+    WalkStack stack;
+    WalkStackInit(&stack);
+    WalkStackPush(&stack, p, PolyCoeffs(&new_poly));
+    while (stack.size != 0) {
+        WalkFrame *top = &stack.frames[stack.size - 1];
+        /* Wielomiany bez węzłów zostały skopiowane razem z węzłem, a liście
+         * kopiuje się w całości */
+        while (top->index != top->size) {
+            const Poly *coeff = &top->coeffs[top->index];
+            if (PolyIsLeaf(coeff))
+                top->other[top->index] = PolyCopyNode(coeff);
+            else if (PolyIsInner(coeff))
+                break;
+            top->index++;
+        }
+        if (top->index == top->size)
+            stack.size--;
+        else {
+            const Poly *coeff = &top->coeffs[top->index];
+            Poly *copy = &top->other[top->index++];
+            *copy = PolyCopyNode(coeff);
+            WalkStackPush(&stack, coeff, PolyCoeffs(copy));
         }
-        return max_deg;
     }
+    WalkStackFree(&stack);
+    return new_poly;
 }
 
-poly_exp_t PolyDeg(const Poly *p) {
-    if (PolyIsZero(p))
-        return -1;
+size_t PolySize(const Poly *p) {
     if (PolyIsCoeff(p))
         return 0;
-    else {
-        poly_exp_t max_deg = -1;
-        for (size_t i = 0; i < p->size; i++) {
-            Mono curr_mono = p->arr[i];
-            poly_exp_t inner_poly_deg = PolyDeg(&curr_mono.p);
-            inner_poly_deg += curr_mono.exp;
+    return PolyIsInline(p) ? 1 : p->size;
+}
 
-            max_deg = MaxExp(max_deg, inner_poly_deg);
-        }
-        return max_deg;
-    }
+Mono PolyGetMono(const Poly *p, size_t i) {
+    assert(i < PolySize(p));
+    MonosView v;
+    MonosViewInit(&v, p);
+    return (Mono) {.p = MonosViewCoeff(&v, i), .exp = v.exps[i]};
 }
 
-Poly PolyNeg(const Poly *p) {
-    if (PolyIsCoeff(p))
-        return PolyFromCoeff((-1) * p->coeff);
+Mono *PolyToMonos(const Poly *p, size_t *count) {
+    if (PolyIsZero(p)) {
+        *count = 0;
+        return NULL;
+    }
+    if (PolyIsCoeff(p)) {
+        Mono *monos = SafeMonoMalloc(1);
+        monos[0] = MonoFromPoly(p, 0);
+        *count = 1;
+        return monos;
+    }
 
-    Mono *new_mono_array = SafeMonoMalloc(p->size);
-    for (size_t i = 0; i < p->size; i++) {
-        Mono new_mono = {.exp = p->arr[i].exp, .p = PolyNeg(&p->arr[i].p)};
-        new_mono_array[i] = new_mono;
+    MonosView v;
+    MonosViewInit(&v, p);
+    Mono *monos = SafeMonoMalloc(v.size);
+    for (size_t i = 0; i < v.size; i++) {
+        Poly coeff = MonosViewCoeff(&v, i);
+        monos[i] = (Mono) {.p = PolyClone(&coeff), .exp = v.exps[i]};
     }
-    return (Poly) {.arr = new_mono_array, .size = p->size};
+    *count = v.size;
+    return monos;
 }
 
 /**
- * Mnoży dwie tablice jednomianów oraz na podstawie tablicy wynikowej tworzy
- * wielomian.
- * @param[in] p : tablica jednomianów
- * @param[in] q : tablica jednomianów
- * @param[in] p_size : rozmiar tablicy @p p
- * @param[in] q_size : rozmiar tablicy @p q
- * @return wielomian o wspólczynniku w postaci iloczynu tablic @p p i @p q
+ * Sprawdza, czy tablica jednomianów jest posortowana niemalejąco względem
+ * wykładników.
+ * @param[in] monos : tablica jednomianów
+ * @param[in] size : rozmiar tablicy @p monos
+ * @return Czy tablica jest posortowana?
  */
-static Poly PolyMulArrays(const Mono *p, const Mono *q, size_t p_size, size_t q_size) {
-    assert(p != NULL && q != NULL);
-    Poly poly_accumulator = PolyZero();
-    for (size_t i = 0; i < p_size; i++) {
-        Mono *new_array = SafeMonoMalloc(q_size);
-        Mono curr_mono = p[i];
-        /* Mnoży tablicę q przez obecny jednomian */
-        for (size_t j = 0; j < q_size; j++) {
-            Mono new_mono;
-            new_mono.p = PolyMul(&(curr_mono.p), &(q[j].p));
-            new_mono.exp = curr_mono.exp + q[j].exp;
-            new_array[j] = new_mono;
-        }
-        /* Dodaje wynik operacji do wielomianu gromadzącego sumy wyników */
-        Poly temp_poly = (Poly) {.arr = new_array, .size = q_size};
-        Poly new_poly = PolyAdd(&poly_accumulator, &temp_poly);
-        PolyDestroy(&poly_accumulator);
-        poly_accumulator = new_poly;
-        PolyDestroy(&temp_poly);
+static bool MonosAreSorted(const Mono *monos, size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        if (monos[i].exp < monos[i - 1].exp)
+            return false;
     }
-    return poly_accumulator;
+    return true;
 }
 
+/** Liczba bitów cyfry wykładnika w sortowaniu @ref RadixSortMonos. */
+#define RADIX_BITS 8
+/** Liczba różnych wartości cyfry w @ref RadixSortMonos. */
+#define RADIX_SIZE (1 << RADIX_BITS)
+/** Rozmiar tablicy, poniżej którego @ref RadixSortMonos sortuje przez wstawianie. */
+#define INSERTION_SORT_THRESHOLD 32
+
 /**
- * Mnoży wielomian przez liczbę.
- * @param[in] p : wielomian
- * @param[in] c : współczynnik
- * @return @f$ p\cdot c@f$
+ * Daje cyfrę wykładnika jednomianu.
+ * @param[in] m : jednomian
+ * @param[in] shift : pozycja najmłodszego bitu cyfry w wykładniku
+ * @return cyfra wykładnika
  */
-static Poly PolyMulByCoeff(const Poly *p, poly_coeff_t c) {
-    if (c == 0) return PolyZero();
-
-    if (PolyIsCoeff(p))
-        return PolyFromCoeff(c * p->coeff);
+static size_t ExpDigit(const Mono *m, unsigned shift) {
+    return ((unsigned) m->exp >> shift) & (RADIX_SIZE - 1);
+}
 
-    Mono *new_mono_array = malloc(p->size * sizeof(Mono));
-    size_t index = 0;
-    for (size_t i = 0; i < p->size; i++) {
-        Mono new_mono = {.exp = p->arr[i].exp, .p = PolyMulByCoeff(&p->arr[i].p, c)};
-        if (!PolyIsZero(&new_mono.p))
-            new_mono_array[index++] = new_mono;
+/**
+ * Sortuje przez wstawianie tablicę jednomianów względem wykładników.
+ * @param[in,out] monos : tablica jednomianów
+ * @param[in] size : rozmiar tablicy @p monos
+ */
+static void InsertionSortMonos(Mono *monos, size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        Mono m = monos[i];
+        size_t j = i;
+        while (j > 0 && monos[j - 1].exp > m.exp) {
+            monos[j] = monos[j - 1];
+            j--;
+        }
+        monos[j] = m;
     }
-    Poly new_poly = (Poly) {.arr = new_mono_array, .size = index};
+}
 
-    /* Sprawdza, czy przy mnożeniu czegoś niezerowego nie doszło do overflow
-     * i wielomian nie ma zerowych współczynników. */
-    if (index == 0) {
-        free(new_mono_array);
-        return PolyZero();
+/**
+ * Sortuje w miejscu tablicę jednomianów względem wykładników, zaczynając od
+ * najstarszej cyfry (sortowanie pozycyjne MSD, bez dodatkowej tablicy).
+ * Jednomiany są rozstawiane do kubełków odpowiadających cyfrze wykładnika
+ * przez zamiany, a potem kubełki są sortowane względem kolejnej cyfry.
+ * @param[in,out] monos : tablica jednomianów
+ * @param[in] size : rozmiar tablicy @p monos
+ * @param[in] shift : pozycja najmłodszego bitu cyfry w wykładniku
+ */
+static void RadixSortMonos(Mono *monos, size_t size, unsigned shift) {
+    if (size <= INSERTION_SORT_THRESHOLD) {
+        InsertionSortMonos(monos, size);
+        return;
     }
 
-    else return new_poly;
-}
+    size_t bucket_begin[RADIX_SIZE] = {0};
+    size_t bucket_end[RADIX_SIZE];
+    for (size_t i = 0; i < size; i++)
+        bucket_begin[ExpDigit(&monos[i], shift)]++;
+    size_t position = 0;
+    for (size_t digit = 0; digit < RADIX_SIZE; digit++) {
+        size_t digit_count = bucket_begin[digit];
+        bucket_begin[digit] = position;
+        position += digit_count;
+        bucket_end[digit] = position;
+    }
 
-Poly PolyMul(const Poly *p, const Poly *q) {
-    if (PolyIsCoeff(p) && PolyIsCoeff(q))
-        return PolyFromCoeff(p->coeff * q->coeff);
+    /* Rozstawia jednomiany; bucket_begin wskazuje pierwsze miejsce kubełka,
+     * na którym może nie być jeszcze właściwego jednomianu */
+    for (size_t digit = 0; digit < RADIX_SIZE; digit++) {
+        while (bucket_begin[digit] != bucket_end[digit]) {
+            Mono m = monos[bucket_begin[digit]];
+            size_t m_digit = ExpDigit(&m, shift);
+            while (m_digit != digit) {
+                Mono temp = monos[bucket_begin[m_digit]];
+                monos[bucket_begin[m_digit]++] = m;
+                m = temp;
+                m_digit = ExpDigit(&m, shift);
+            }
+            monos[bucket_begin[digit]++] = m;
+        }
+    }
 
-    if (!PolyIsCoeff(p) && !PolyIsCoeff(q))
-        return PolyMulArrays(p->arr, q->arr, p->size, q->size);
+    if (shift == 0)
+        return;
+    size_t begin = 0;
+    for (size_t digit = 0; digit < RADIX_SIZE; digit++) {
+        RadixSortMonos(monos + begin, bucket_end[digit] - begin, shift - RADIX_BITS);
+        begin = bucket_end[digit];
+    }
+}
 
-    if (PolyIsCoeff(p) && !PolyIsCoeff(q))
-        return PolyMulByCoeff(q, p->coeff);
+/**
+ * Sortuje w miejscu rosnąco względem wykładników tablicę jednomianów.
+ * Tablica już posortowana jest rozpoznawana w czasie liniowym. Pozostałe są
+ * sortowane pozycyjnie po tylu cyfrach, ile ma największy wykładnik.
+ * @param[in,out] monos : tablica jednomianów
+ * @param[in] size : rozmiar tablicy @p monos
+ */
+static void SortMonos(Mono *monos, size_t size) {
+    if (MonosAreSorted(monos, size))
+        return;
 
-    else return PolyMulByCoeff(p, q->coeff);
+    unsigned max_exp = 0;
+    for (size_t i = 0; i < size; i++)
+        max_exp |= (unsigned) monos[i].exp;
+    unsigned shift = 0;
+    while ((max_exp >> shift) >= RADIX_SIZE)
+        shift += RADIX_BITS;
+    RadixSortMonos(monos, size, shift);
 }
 
-bool PolyIsEq(const Poly *p, const Poly *q) {
-    if (PolyIsCoeff(p) != PolyIsCoeff(q))
-        return false;
-
-    if (PolyIsCoeff(p))
-        return p->coeff == q->coeff;
+/**
+ * Sprawdza, czy wszystkie współczynniki wielomianu są liczbami, czyli czy jest
+ * on liściem lub jednomianem przechowywanym bez węzła.
+ * @param[in] p : wielomian
+ * @return Czy wielomian nie jest współczynnikiem i ma tylko liczbowe
+ * współczynniki?
+ */
+static bool PolyIsFlat(const Poly *p) {
+    return PolyIsInline(p) || PolyIsLeaf(p);
+}
 
-    if (p->size != q->size)
-        return false;
+/** Scalanie wyszukuje galopem ciągi jednomianów, jeśli jeden z wielomianów
+ *  ma ponad tyle razy więcej jednomianów niż drugi. Przy porównywalnych
+ *  rozmiarach ciągi są zwykle krótkie i galop kosztowałby więcej niż zwykłe
+ *  scalanie. */
+#define GALLOP_SIZE_RATIO 8
 
-    for (size_t i = 0; i < p->size; i++) {
-        if (p->arr[i].exp != q->arr[i].exp
-            || !PolyIsEq(&p->arr[i].p, &q->arr[i].p))
-            return false;
+/**
+ * Wyszukuje wykładniczo (galopem) pierwszy wykładnik nie mniejszy od
+ * @p bound. Sprawdza indeksy odległe od @p from o 1, 2, 4, ..., a następnie
+ * wyszukuje binarnie w ostatnim przedziale, więc przeskoczenie @f$k@f$
+ * wykładników kosztuje @f$O(\log k)@f$ porównań.
+ * @param[in] exps : rosnąca tablica wykładników
+ * @param[in] from : indeks, od którego zaczyna się wyszukiwanie
+ * @param[in] size : rozmiar tablicy
+ * @param[in] bound : szukana wartość
+ * @return najmniejszy indeks @f$i \geq from@f$ taki, że
+ * @f$exps[i] \geq bound@f$, lub @p size, jeśli taki nie istnieje
+ */
+static size_t GallopExps(const poly_exp_t *exps, size_t from, size_t size,
+                         poly_exp_t bound) {
+    size_t low = from, step = 1;
+    /* Niezmiennik: wszystkie wykładniki przed indeksem low są mniejsze
+     * od bound */
+    while (low + step < size && exps[low + step] < bound) {
+        low += step;
+        step *= 2;
     }
-    return true;
+    size_t high = low + step < size ? low + step : size;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (exps[mid] < bound)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
 }
 
 /**
- * Szybkie potęgowanie.
- * @param[in] base : podstawa
- * @param[in] exp : wykładnik
- * @return @f$ base^{exp}@f$
+ * Dodaje dwa wielomiany o liczbowych współczynnikach, scalając ich tablice
+ * wykładników i liczb. Jeśli rozmiary wielomianów bardzo się różnią, ciągi
+ * jednomianów jednego z nich leżące przed kolejnym wykładnikiem drugiego są
+ * wyszukiwane galopem i kopiowane w całości, więc dodanie małego wielomianu do
+ * dużego wymaga tylko @f$O(m \log n)@f$ porównań.
+ * @param[in] p : widok wielomianu o liczbowych współczynnikach
+ * @param[in] q : widok wielomianu o liczbowych współczynnikach
+ * @return @f$p + q@f$
  */
-static poly_coeff_t QuickPow(poly_coeff_t base, poly_coeff_t exp) {
-    if (exp == 0)
-        return 1;
-    if (exp % 2 == 1)
+static Poly LeafAdd(const MonosView *p, const MonosView *q) {
+    const poly_exp_t *p_exps = p->exps, *q_exps = q->exps;
+    const poly_coeff_t *p_coeffs = p->values, *q_coeffs = q->values;
+    size_t p_size = p->size, q_size = q->size;
+    size_t capacity = p_size + q_size;
+    PolyNode *node = LeafMalloc(capacity);
+    poly_exp_t *exps = node->exps;
+    poly_coeff_t *coeffs = LeafCoeffs(node, capacity);
+    /* Galop opłaca się tylko, gdy jeden z wielomianów jest dużo dłuższy */
+    bool gallop = p_size > GALLOP_SIZE_RATIO * q_size || q_size > GALLOP_SIZE_RATIO * p_size;
+    size_t index = 0, p_i = 0, q_i = 0;
+    while (p_i != p_size && q_i != q_size) {
+        if (p_exps[p_i] < q_exps[q_i]) {
+            if (!gallop) {
+                exps[index] = p_exps[p_i];
+                coeffs[index++] = p_coeffs[p_i++];
+            }
+            else {
+                size_t end = GallopExps(p_exps, p_i, p_size, q_exps[q_i]);
+                memcpy(exps + index, p_exps + p_i, (end - p_i) * sizeof(poly_exp_t));
+                memcpy(coeffs + index, p_coeffs + p_i, (end - p_i) * sizeof(poly_coeff_t));
+                index += end - p_i;
+                p_i = end;
+            }
+        }
+        else if (p_exps[p_i] > q_exps[q_i]) {
+            if (!gallop) {
+                exps[index] = q_exps[q_i];
+                coeffs[index++] = q_coeffs[q_i++];
+            }
+            else {
+                size_t end = GallopExps(q_exps, q_i, q_size, p_exps[p_i]);
+                memcpy(exps + index, q_exps + q_i, (end - q_i) * sizeof(poly_exp_t));
+                memcpy(coeffs + index, q_coeffs + q_i, (end - q_i) * sizeof(poly_coeff_t));
+                index += end - q_i;
+                q_i = end;
+            }
+        }
+        else {
+            poly_coeff_t sum = p_coeffs[p_i] + q_coeffs[q_i];
+            if (sum != 0) {
+                exps[index] = p_exps[p_i];
+                coeffs[index++] = sum;
+            }
+            p_i++;
+            q_i++;
+        }
+    }
+    memcpy(exps + index, p_exps + p_i, (p_size - p_i) * sizeof(poly_exp_t));
+    memcpy(coeffs + index, p_coeffs + p_i, (p_size - p_i) * sizeof(poly_coeff_t));
+    index += p_size - p_i;
+    memcpy(exps + index, q_exps + q_i, (q_size - q_i) * sizeof(poly_exp_t));
+    memcpy(coeffs + index, q_coeffs + q_i, (q_size - q_i) * sizeof(poly_coeff_t));
+    index += q_size - q_i;
+    return PolyFromLeaf(node, capacity, index);
+}
+
+/**
+ * Kopiuje do węzła jednomiany o indeksach od @p from do @p end - 1 z widoku.
+ * Wykładniki są kopiowane w całości, a współczynniki - klonowane.
+ * @param[in,out] exps : tablica wykładników węzła
+ * @param[in,out] coeffs : tablica współczynników węzła
+ * @param[in] index : pierwsze wolne miejsce w węźle
+ * @param[in] v : widok wielomianu
+ * @param[in] from : indeks pierwszego kopiowanego jednomianu
+ * @param[in] end : indeks za ostatnim kopiowanym jednomianem
+ * @return pierwsze wolne miejsce w węźle po skopiowaniu
+ */
+static size_t CopyMonosRun(poly_exp_t *exps, Poly *coeffs, size_t index,
+                           const MonosView *v, size_t from, size_t end) {
+    memcpy(exps + index, v->exps + from, (end - from) * sizeof(poly_exp_t));
+    for (size_t i = from; i < end; i++) {
+        Poly coeff = MonosViewCoeff(v, i);
+        coeffs[index++] = PolyClone(&coeff);
+    }
+    return index;
+}
+
+/**
+ * Dodaje dwa wielomiany, które nie są współczynnikami i z których co najmniej
+ * jeden ma współczynnik niebędący liczbą. Podobnie jak w @ref LeafAdd ciągi
+ * jednomianów bez odpowiedników w drugim wielomianie są wyszukiwane galopem,
+ * jeśli rozmiary wielomianów bardzo się różnią.
+ * @param[in] p : widok wielomianu @f$p@f$
+ * @param[in] q : widok wielomianu @f$q@f$
+ * @return @f$p + q@f$
+ */
+static Poly AddNodes(const MonosView *p, const MonosView *q) {
+    const poly_exp_t *p_exps = p->exps, *q_exps = q->exps;
+    size_t p_size = p->size, q_size = q->size;
+    size_t capacity = p_size + q_size;
+    PolyNode *node = NodeMalloc(capacity);
+    poly_exp_t *exps = node->exps;
+    Poly *coeffs = NodeCoeffs(node, capacity);
+    bool gallop = p_size > GALLOP_SIZE_RATIO * q_size || q_size > GALLOP_SIZE_RATIO * p_size;
+    size_t index = 0, p_i = 0, q_i = 0;
+    while (p_i != p_size && q_i != q_size) {
+        /* Wpisuje kopie jednomianów o wykładnikach mniejszych od bieżącego
+         * wykładnika drugiego wielomianu */
+        if (p_exps[p_i] < q_exps[q_i]) {
+            size_t end = gallop ? GallopExps(p_exps, p_i, p_size, q_exps[q_i]) : p_i + 1;
+            index = CopyMonosRun(exps, coeffs, index, p, p_i, end);
+            p_i = end;
+        }
+        else if (p_exps[p_i] > q_exps[q_i]) {
+            size_t end = gallop ? GallopExps(q_exps, q_i, q_size, p_exps[p_i]) : q_i + 1;
+            index = CopyMonosRun(exps, coeffs, index, q, q_i, end);
+            q_i = end;
+        }
+        /* Gdy w obu wielomianach są jednomiany o tym samym wykładniku, zostaje
+         * zapisana ich suma (o ile nie jest zerem) */
+        else {
+            Poly p_coeff = MonosViewCoeff(p, p_i), q_coeff = MonosViewCoeff(q, q_i);
+            Poly sum = PolyAdd(&p_coeff, &q_coeff);
+            if (!PolyIsZero(&sum)) {
+                exps[index] = p_exps[p_i];
+                coeffs[index++] = sum;
+            }
+            p_i++;
+            q_i++;
+        }
+    }
+    index = CopyMonosRun(exps, coeffs, index, p, p_i, p_size);
+    index = CopyMonosRun(exps, coeffs, index, q, q_i, q_size);
+    return PolyFromNode(node, capacity, index);
+}
+
+/**
+ * Dodaje wielomian stały do wielomianu, który nie jest współczynnikiem.
+ * @param[in] p : wielomian, który nie jest współczynnikiem
+ * @param[in] c : wartość wielomianu stałego
+ * @return @f$p + c@f$
+ */
+static Poly PolyAddCoeff(const Poly *p, poly_coeff_t c) {
+    if (c == 0)
+        return PolyClone(p);
+
+    MonosView v;
+    MonosViewInit(&v, p);
+    const poly_exp_t *p_exps = v.exps;
+    /* Jednomian o wykładniku 0 może być tylko pierwszy */
+    size_t skip = p_exps[0] == 0 ? 1 : 0;
+    size_t capacity = v.size + 1 - skip;
+    if (v.values != NULL) {
+        const poly_coeff_t *p_coeffs = v.values;
+        PolyNode *node = LeafMalloc(capacity);
+        poly_coeff_t *coeffs = LeafCoeffs(node, capacity);
+        poly_coeff_t constant = skip ? p_coeffs[0] + c : c;
+        size_t index = 0;
+        if (constant != 0) {
+            node->exps[0] = 0;
+            coeffs[index++] = constant;
+        }
+        memcpy(node->exps + index, p_exps + skip, (v.size - skip) * sizeof(poly_exp_t));
+        memcpy(coeffs + index, p_coeffs + skip, (v.size - skip) * sizeof(poly_coeff_t));
+        return PolyFromLeaf(node, capacity, index + v.size - skip);
+    }
+
+    const Poly *p_coeffs = v.coeffs;
+    PolyNode *node = NodeMalloc(capacity);
+    Poly *coeffs = NodeCoeffs(node, capacity);
+    Poly constant = PolyFromCoeff(c);
+    if (skip)
+        constant = PolyAdd(&p_coeffs[0], &constant);
+    size_t index = 0;
+    if (!PolyIsZero(&constant)) {
+        node->exps[0] = 0;
+        coeffs[index++] = constant;
+    }
+    for (size_t i = skip; i < v.size; i++) {
+        node->exps[index] = p_exps[i];
+        coeffs[index++] = PolyClone(&p_coeffs[i]);
+    }
+    return PolyFromNode(node, capacity, index);
+}
+
+Poly PolyAdd(const Poly *p, const Poly *q) {
+    if (PolyIsCoeff(p) && PolyIsCoeff(q))
+        return PolyFromCoeff(p->coeff + q->coeff);
+    if (PolyIsCoeff(p))
+        return PolyAddCoeff(q, p->coeff);
+    if (PolyIsCoeff(q))
+        return PolyAddCoeff(p, q->coeff);
+    /* Suma jednomianów o tym samym wykładniku nie wymaga alokacji */
+    if (PolyIsInline(p) && PolyIsInline(q) && InlineExp(p) == InlineExp(q))
+        return PolyFromTerm(p->coeff + q->coeff, InlineExp(p));
+
+    MonosView p_view, q_view;
+    MonosViewInit(&p_view, p);
+    MonosViewInit(&q_view, q);
+    if (PolyIsFlat(p) && PolyIsFlat(q))
+        return LeafAdd(&p_view, &q_view);
+    return AddNodes(&p_view, &q_view);
+}
+
+Poly PolySub(const Poly *p, const Poly *q) {
+    Poly q_neg = PolyNeg(q);
+    Poly result = PolyAdd(p, &q_neg);
+    PolyDestroy(&q_neg);
+    return result;
+}
+
+/**
+ * Upraszcza w miejscu tablicę @p monos: sortuje ją rosnąco względem
+ * wykładników, sumuje jednomiany o równych wykładnikach i usuwa jednomiany
+ * o zerowych współczynnikach. Przejmuje na własność zawartość tablicy.
+ * Wynikowe jednomiany zajmują początek tablicy @p monos.
+ * @param[in,out] monos : tablica jednomianów
+ * @param[in] size : rozmiar tablicy @p monos
+ * @return liczba jednomianów w uproszczonej tablicy
+ */
+static size_t SimplifyMonos(Mono *monos, size_t size) {
+    SortMonos(monos, size);
+    size_t index = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (PolyIsZero(&monos[i].p))
+            continue;
+        if (index != 0 && monos[index - 1].exp == monos[i].exp) {
+            Poly sum = PolyAdd(&monos[index - 1].p, &monos[i].p);
+            MonoDestroy(&monos[index - 1]);
+            MonoDestroy(&monos[i]);
+            monos[index - 1].p = sum;
+            /* Jeśli jednomiany się zredukowały, ich miejsce zajmie następny */
+            if (PolyIsZero(&sum))
+                index--;
+        }
+        else
+            monos[index++] = monos[i];
+    }
+    return index;
+}
+
+
+/**
+ * Zamienia tablicę jednomianów zaalokowaną na stercie w węzeł, zmieniając jej
+ * rozmiar funkcją realloc. Współczynniki są przesuwane w obrębie tablicy,
+ * a wykładniki na czas przestawiania pamięci trafiają do tablicy pomocniczej.
+ * @param[in] monos : tablica jednomianów
+ * @param[in] size : liczba jednomianów w tablicy
+ * @param[in] leaf : czy wszystkie współczynniki są liczbami
+ * @return węzeł (liść, jeśli @p leaf) z jednomianami z tablicy @p monos
+ */
+static PolyNode *NodeAdoptMonos(Mono *monos, size_t size, bool leaf) {
+    poly_exp_t *exps = malloc(size * sizeof(poly_exp_t));
+    if (exps == NULL) exit(1);
+    /* Współczynnik i-tego jednomianu trafia na miejsce, które zajmowały
+     * jednomiany o indeksach nie większych niż i */
+    Poly *coeffs = (Poly *) monos;
+    poly_coeff_t *values = (poly_coeff_t *) monos;
+    for (size_t i = 0; i < size; i++) {
+        exps[i] = monos[i].exp;
+        if (leaf) {
+            poly_coeff_t c = monos[i].p.coeff;
+            values[i] = c;
+        }
+        else
+            memmove(&coeffs[i], &monos[i].p, sizeof(Poly));
+    }
+
+    size_t coeffs_bytes = size * (leaf ? sizeof(poly_coeff_t) : sizeof(Poly));
+    PolyNode *node = realloc(monos, leaf ? LeafBytes(size) : NodeBytes(size));
+    if (node == NULL) exit(1);
+    memmove((char *) node + NodeCoeffsOffset(size), node, coeffs_bytes);
+    memcpy(node->exps, exps, size * sizeof(poly_exp_t));
+    node->leaf = leaf;
+    free(exps);
+    return node;
+}
+
+Poly PolyOwnMonos(size_t count, Mono *monos) {
+    size_t new_size = count == 0 ? 0 : SimplifyMonos(monos, count);
+    /* Gdy wszystko uprościło się do zera lub do jednomianu, który nie
+     * potrzebuje węzła */
+    if (new_size == 0 || (new_size == 1 && PolyIsCoeff(&monos[0].p))) {
+        Poly result = new_size == 0 ? PolyZero()
+                                    : PolyFromTerm(monos[0].p.coeff, monos[0].exp);
+        free(monos);
+        return result;
+    }
+
+    bool leaf = true;
+    for (size_t i = 0; i < new_size && leaf; i++)
+        leaf = PolyIsCoeff(&monos[i].p);
+    PolyNode *node = NodeAdoptMonos(monos, new_size, leaf);
+    if (leaf)
+        return PolyFromLeaf(node, new_size, new_size);
+    return PolyFromNode(node, new_size, new_size);
+}
+
+Poly PolyAddMonos(size_t count, const Mono monos[]) {
+    if (count == 0)
+        return PolyZero();
+    if (count == 1 && PolyIsCoeff(&monos[0].p))
+        return PolyFromTerm(monos[0].p.coeff, monos[0].exp);
+
+    Mono *copy = SafeMonoMalloc(count);
+    for (size_t i = 0; i < count; i++)
+        copy[i] = monos[i];
+    return PolyOwnMonos(count, copy);
+}
+
+Poly PolyCloneMonos(size_t count, const Mono monos[]) {
+    if (count == 0 || monos == NULL)
+        return PolyZero();
+    if (count == 1 && PolyIsCoeff(&monos[0].p))
+        return PolyFromTerm(monos[0].p.coeff, monos[0].exp);
+
+    Mono *copy = SafeMonoMalloc(count);
+    for (size_t i = 0; i < count; i++)
+        copy[i] = MonoClone(&monos[i]);
+    return PolyOwnMonos(count, copy);
+}
+
+poly_exp_t PolyDegBy(const Poly *p, size_t var_idx) {
+    if (var_idx < DEG_CACHE_LEVELS)
+        return PolyCachedDegBy(p, var_idx);
+    if (!PolyIsInner(p))
+        return PolyIsZero(p) ? -1 : 0;
+
+    /* Zmienna x_{var_idx} jest zmienną wielomianów na głębokości var_idx,
+     * ale stopnie ze względu na nią można odczytać z nagłówków węzłów
+     * leżących DEG_CACHE_LEVELS - 1 poziomów wyżej. */
+    poly_exp_t max_deg = -1;
+    WalkStack stack;
+    WalkStackInit(&stack);
+    WalkStackPush(&stack, p, NULL);
+    while (stack.size != 0) {
+        WalkFrame *top = &stack.frames[stack.size - 1];
+        if (top->index == top->size) {
+            stack.size--;
+            continue;
+        }
+        const Poly *coeff = &top->coeffs[top->index++];
+        size_t coeff_var_idx = var_idx - stack.size;
+        if (coeff_var_idx < DEG_CACHE_LEVELS)
+            max_deg = MaxExp(max_deg, PolyCachedDegBy(coeff, coeff_var_idx));
+        else if (!PolyIsInner(coeff))
+            max_deg = MaxExp(max_deg, 0);
+        else
+            WalkStackPush(&stack, coeff, NULL);
+    }
+    WalkStackFree(&stack);
+    return max_deg;
+}
+
+poly_exp_t PolyDeg(const Poly *p) {
+    if (PolyIsCoeff(p))
+        return PolyIsZero(p) ? -1 : 0;
+    if (PolyIsInline(p))
+        return InlineExp(p);
+    return p->node->deg;
+}
+
+Poly PolyNeg(const Poly *p) {
+    if (PolyIsCoeff(p))
+        return PolyFromCoeff((-1) * p->coeff);
+    if (PolyIsInline(p))
+        return PolyInline((-1) * p->coeff, InlineExp(p));
+
+    /* Nagłówek i wykładniki się nie zmieniają */
+    if (PolyIsLeaf(p)) {
+        PolyNode *node = LeafMalloc(p->size);
+        memcpy(node, p->node, NodeCoeffsOffset(p->size));
+        poly_coeff_t *coeffs = LeafCoeffs(node, p->size);
+        const poly_coeff_t *p_coeffs = PolyLeafCoeffs(p);
+        for (size_t i = 0; i < p->size; i++)
+            coeffs[i] = -p_coeffs[i];
+        return (Poly) {.node = node, .size = p->size};
+    }
+
+    PolyNode *node = NodeMalloc(p->size);
+    memcpy(node, p->node, NodeCoeffsOffset(p->size));
+    Poly *coeffs = NodeCoeffs(node, p->size);
+    const Poly *p_coeffs = PolyCoeffs(p);
+    for (size_t i = 0; i < p->size; i++)
+        coeffs[i] = PolyNeg(&p_coeffs[i]);
+    return (Poly) {.node = node, .size = p->size};
+}
+
+/** Iloczyn liści jest liczony w tablicy indeksowanej wykładnikami, jeśli jej
+ *  rozmiar nie przekracza tylu iloczynów par jednomianów. */
+#define LEAF_MUL_DENSE_FACTOR 4
+
+/**
+ * Tworzy liść z tablicy współczynników indeksowanej wykładnikami i zwalnia
+ * tę tablicę.
+ * @param[in] dense : tablica współczynników zaalokowana na stercie
+ * @param[in] min_exp : wykładnik odpowiadający indeksowi 0
+ * @param[in] range : rozmiar tablicy
+ * @return wielomian o niezerowych współczynnikach z tablicy
+ */
+static Poly LeafFromDense(poly_coeff_t *dense, poly_exp_t min_exp, size_t range) {
+    size_t count = 0;
+    for (size_t k = 0; k < range; k++)
+        count += dense[k] != 0;
+
+    PolyNode *node = LeafMalloc(count);
+    poly_coeff_t *coeffs = LeafCoeffs(node, count);
+    size_t index = 0;
+    for (size_t k = 0; k < range; k++) {
+        if (dense[k] != 0) {
+            node->exps[index] = min_exp + (poly_exp_t) k;
+            coeffs[index++] = dense[k];
+        }
+    }
+    free(dense);
+    return PolyFromLeaf(node, count, count);
+}
+
+/**
+ * Mnoży dwa wielomiany o liczbowych współczynnikach. Jeśli wykładniki
+ * iloczynu leżą w niedużym przedziale, iloczyny par jednomianów są sumowane
+ * w tablicy indeksowanej wykładnikami, a w przeciwnym razie - sortowane
+ * i scalane.
+ * @param[in] p : widok wielomianu o liczbowych współczynnikach
+ * @param[in] q : widok wielomianu o liczbowych współczynnikach
+ * @return @f$p \cdot q@f$
+ */
+static Poly LeafMul(const MonosView *p, const MonosView *q) {
+    const poly_exp_t *p_exps = p->exps, *q_exps = q->exps;
+    const poly_coeff_t *p_coeffs = p->values, *q_coeffs = q->values;
+    size_t p_size = p->size, q_size = q->size;
+    poly_exp_t min_exp = p_exps[0] + q_exps[0];
+    poly_exp_t max_exp = p_exps[p_size - 1] + q_exps[q_size - 1];
+    size_t range = (size_t) (max_exp - min_exp) + 1;
+
+    if (range > LEAF_MUL_DENSE_FACTOR * p_size * q_size) {
+        Mono *products = SafeMonoMalloc(p_size * q_size);
+        for (size_t i = 0; i < p_size; i++)
+            for (size_t j = 0; j < q_size; j++)
+                products[i * q_size + j] = (Mono) {
+                    .p = PolyFromCoeff(p_coeffs[i] * q_coeffs[j]),
+                    .exp = p_exps[i] + q_exps[j]};
+        return PolyOwnMonos(p_size * q_size, products);
+    }
+
+    poly_coeff_t *dense = calloc(range, sizeof(poly_coeff_t));
+    if (dense == NULL) exit(1);
+    for (size_t i = 0; i < p_size; i++)
+        for (size_t j = 0; j < q_size; j++)
+            dense[p_exps[i] + q_exps[j] - min_exp] += p_coeffs[i] * q_coeffs[j];
+    return LeafFromDense(dense, min_exp, range);
+}
+
+/**
+ * Mnoży dwa wielomiany, które nie są współczynnikami.
+ * @param[in] p : widok wielomianu @f$p@f$
+ * @param[in] q : widok wielomianu @f$q@f$
+ * @return @f$p \cdot q@f$
+ */
+static Poly PolyMulNodes(const MonosView *p, const MonosView *q) {
+    const poly_exp_t *p_exps = p->exps, *q_exps = q->exps;
+    Poly poly_accumulator = PolyZero();
+    for (size_t i = 0; i < p->size; i++) {
+        PolyNode *node = NodeMalloc(q->size);
+        Poly *coeffs = NodeCoeffs(node, q->size);
+        Poly p_coeff = MonosViewCoeff(p, i);
+        size_t index = 0;
+        /* Mnoży wielomian q przez obecny jednomian */
+        for (size_t j = 0; j < q->size; j++) {
+            Poly q_coeff = MonosViewCoeff(q, j);
+            Poly product = PolyMul(&p_coeff, &q_coeff);
+            if (!PolyIsZero(&product)) {
+                node->exps[index] = p_exps[i] + q_exps[j];
+                coeffs[index++] = product;
+            }
+        }
+        /* Dodaje wynik operacji do wielomianu gromadzącego sumy wyników */
+        Poly temp_poly = PolyFromNode(node, q->size, index);
+        Poly new_poly = PolyAdd(&poly_accumulator, &temp_poly);
+        PolyDestroy(&poly_accumulator);
+        poly_accumulator = new_poly;
+        PolyDestroy(&temp_poly);
+    }
+    return poly_accumulator;
+}
+
+/**
+ * Mnoży wielomian przez liczbę.
+ * @param[in] p : wielomian
+ * @param[in] c : współczynnik
+ * @return @f$ p\cdot c@f$
+ */
+static Poly PolyMulByCoeff(const Poly *p, poly_coeff_t c) {
+    if (c == 0) return PolyZero();
+
+    if (PolyIsCoeff(p))
+        return PolyFromCoeff(c * p->coeff);
+    /* Przy mnożeniu czegoś niezerowego mogło dojść do overflow */
+    if (PolyIsInline(p))
+        return PolyFromTerm(c * p->coeff, InlineExp(p));
+
+    if (PolyIsLeaf(p)) {
+        PolyNode *node = LeafMalloc(p->size);
+        poly_coeff_t *coeffs = LeafCoeffs(node, p->size);
+        const poly_coeff_t *p_coeffs = PolyLeafCoeffs(p);
+        size_t index = 0;
+        for (size_t i = 0; i < p->size; i++) {
+            poly_coeff_t product = p_coeffs[i] * c;
+            if (product != 0) {
+                node->exps[index] = p->node->exps[i];
+                coeffs[index++] = product;
+            }
+        }
+        return PolyFromLeaf(node, p->size, index);
+    }
+
+    PolyNode *node = NodeMalloc(p->size);
+    Poly *coeffs = NodeCoeffs(node, p->size);
+    const Poly *p_coeffs = PolyCoeffs(p);
+    size_t index = 0;
+    for (size_t i = 0; i < p->size; i++) {
+        Poly product = PolyMulByCoeff(&p_coeffs[i], c);
+        /* Przy mnożeniu czegoś niezerowego mogło dojść do overflow */
+        if (!PolyIsZero(&product)) {
+            node->exps[index] = p->node->exps[i];
+            coeffs[index++] = product;
+        }
+    }
+    return PolyFromNode(node, p->size, index);
+}
+
+Poly PolyMul(const Poly *p, const Poly *q) {
+    if (PolyIsCoeff(p) && PolyIsCoeff(q))
+        return PolyFromCoeff(p->coeff * q->coeff);
+
+    /* Iloczyn jednomianów nie wymaga alokacji */
+    if (PolyIsInline(p) && PolyIsInline(q))
+        return PolyFromTerm(p->coeff * q->coeff, InlineExp(p) + InlineExp(q));
+
+    if (!PolyIsCoeff(p) && !PolyIsCoeff(q)) {
+        MonosView p_view, q_view;
+        MonosViewInit(&p_view, p);
+        MonosViewInit(&q_view, q);
+        if (PolyIsFlat(p) && PolyIsFlat(q))
+            return LeafMul(&p_view, &q_view);
+        return PolyMulNodes(&p_view, &q_view);
+    }
+
+    if (PolyIsCoeff(p) && !PolyIsCoeff(q))
+        return PolyMulByCoeff(q, p->coeff);
+
+    else return PolyMulByCoeff(p, q->coeff);
+}
+
+/**
+ * Przenosi jednomiany wielomianu do tablicy, nie kopiując współczynników,
+ * i zwalnia jego węzeł.
+ * @param[in] p : wielomian przejmowany na własność
+ * @param[out] monos : tablica na co najmniej @ref PolySize (lub 1 dla
+ * współczynnika) jednomianów
+ * @return liczba przeniesionych jednomianów
+ */
+static size_t PolyMoveToMonos(Poly *p, Mono *monos) {
+    MonosView v;
+    MonosViewInit(&v, p);
+    for (size_t i = 0; i < v.size; i++)
+        monos[i] = (Mono) {.p = MonosViewCoeff(&v, i), .exp = v.exps[i]};
+    if (PolyHasNode(p))
+        free(p->node);
+    *p = PolyZero();
+    return v.size;
+}
+
+/**
+ * Dodaje do wielomianu o liczbowych współczynnikach iloczyn dwóch takich
+ * wielomianów, sumując wszystkie jednomiany w tablicy indeksowanej
+ * wykładnikami (jak w @ref LeafMul). Wynik zastępuje @p r.
+ * @param[in,out] r : widok wielomianu @f$r@f$
+ * @param[in] p : widok wielomianu @f$p@f$
+ * @param[in] q : widok wielomianu @f$q@f$
+ * @param[in] min_exp : najmniejszy wykładnik w @f$r@f$ i @f$p \cdot q@f$
+ * @param[in] range : liczba wykładników od @p min_exp do największego
+ * @return @f$r + p \cdot q@f$
+ */
+static Poly LeafMulAdd(const MonosView *r, const MonosView *p, const MonosView *q,
+                       poly_exp_t min_exp, size_t range) {
+    poly_coeff_t *dense = calloc(range, sizeof(poly_coeff_t));
+    if (dense == NULL) exit(1);
+    for (size_t k = 0; k < r->size; k++)
+        dense[r->exps[k] - min_exp] = r->values[k];
+    for (size_t i = 0; i < p->size; i++)
+        for (size_t j = 0; j < q->size; j++)
+            dense[p->exps[i] + q->exps[j] - min_exp] += p->values[i] * q->values[j];
+    return LeafFromDense(dense, min_exp, range);
+}
+
+/**
+ * Wyszukuje binarnie jednomian o wykładniku @p exp w posortowanej tablicy
+ * jednomianów o różnych wykładnikach.
+ * @param[in] monos : tablica jednomianów
+ * @param[in] low : indeks, od którego zaczyna się wyszukiwanie
+ * @param[in] size : rozmiar tablicy
+ * @param[in] exp : wykładnik, który występuje w tablicy
+ * @return indeks jednomianu o wykładniku @p exp
+ */
+static size_t FindMonoExp(const Mono *monos, size_t low, size_t size, poly_exp_t exp) {
+    size_t high = size;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (monos[mid].exp < exp)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    assert(low < size && monos[low].exp == exp);
+    return low;
+}
+
+/**
+ * Sortuje tablicę jednomianów o zerowych współczynnikach i usuwa z niej
+ * powtarzające się wykładniki.
+ * @param[in,out] monos : tablica jednomianów
+ * @param[in] size : rozmiar tablicy
+ * @return liczba różnych wykładników, które zajmują początek tablicy
+ */
+static size_t SortUniqueExps(Mono *monos, size_t size) {
+    SortMonos(monos, size);
+    size_t unique = 0;
+    for (size_t k = 0; k < size; k++)
+        if (unique == 0 || monos[unique - 1].exp != monos[k].exp)
+            monos[unique++] = monos[k];
+    return unique;
+}
+
+void PolyMulAdd(Poly *r, const Poly *p, const Poly *q) {
+    if (PolyIsZero(p) || PolyIsZero(q))
+        return;
+    /* Gdy r jest jednym z czynników, nie można go zmieniać w trakcie
+     * mnożenia */
+    if (p == r || q == r) {
+        Poly product = PolyMul(p, q);
+        Poly sum = PolyAdd(r, &product);
+        PolyDestroy(&product);
+        PolyDestroy(r);
+        *r = sum;
+        return;
+    }
+    if (PolyIsCoeff(p) && PolyIsCoeff(q) && PolyIsCoeff(r)) {
+        r->coeff += p->coeff * q->coeff;
+        return;
+    }
+
+    MonosView p_view, q_view, r_view;
+    MonosViewInit(&p_view, p);
+    MonosViewInit(&q_view, q);
+    MonosViewInit(&r_view, r);
+    size_t products = p_view.size * q_view.size;
+    if (p_view.values != NULL && q_view.values != NULL && r_view.values != NULL) {
+        poly_exp_t min_exp = p_view.exps[0] + q_view.exps[0];
+        poly_exp_t max_exp = p_view.exps[p_view.size - 1] + q_view.exps[q_view.size - 1];
+        if (r_view.size != 0) {
+            min_exp = min_exp < r_view.exps[0] ? min_exp : r_view.exps[0];
+            max_exp = MaxExp(max_exp, r_view.exps[r_view.size - 1]);
+        }
+        size_t range = (size_t) (max_exp - min_exp) + 1;
+        if (range <= LEAF_MUL_DENSE_FACTOR * (products + r_view.size)) {
+            Poly result = LeafMulAdd(&r_view, &p_view, &q_view, min_exp, range);
+            PolyDestroy(r);
+            *r = result;
+            return;
+        }
+    }
+
+    /* Zerowe jednomiany o wykładnikach iloczynów par jednomianów p i q,
+     * do których są dodawane te iloczyny; tylko je trzeba posortować */
+    Mono *slots = SafeMonoMalloc(products);
+    size_t slots_size = 0;
+    for (size_t i = 0; i < p_view.size; i++)
+        for (size_t j = 0; j < q_view.size; j++)
+            slots[slots_size++] = (Mono) {.p = PolyZero(), .exp = p_view.exps[i] + q_view.exps[j]};
+    slots_size = SortUniqueExps(slots, slots_size);
+
+    /* Scala je z przeniesionymi jednomianami r, które leżą na końcu tablicy;
+     * miejsce zapisu nigdy nie wyprzedza miejsca odczytu */
+    Mono *monos = SafeMonoMalloc(slots_size + r_view.size);
+    size_t r_size = PolyMoveToMonos(r, monos + slots_size);
+    size_t unique = 0, slot_i = 0, r_i = slots_size, r_end = slots_size + r_size;
+    while (slot_i != slots_size || r_i != r_end) {
+        if (r_i == r_end || (slot_i != slots_size && slots[slot_i].exp < monos[r_i].exp))
+            monos[unique++] = slots[slot_i++];
+        else {
+            if (slot_i != slots_size && slots[slot_i].exp == monos[r_i].exp)
+                slot_i++;
+            monos[unique++] = monos[r_i++];
+        }
+    }
+    free(slots);
+
+    for (size_t i = 0; i < p_view.size; i++) {
+        Poly p_coeff = MonosViewCoeff(&p_view, i);
+        /* Dla ustalonego i wykładniki iloczynów rosną razem z j */
+        size_t pos = 0;
+        for (size_t j = 0; j < q_view.size; j++) {
+            Poly q_coeff = MonosViewCoeff(&q_view, j);
+            pos = FindMonoExp(monos, pos, unique, p_view.exps[i] + q_view.exps[j]);
+            PolyMulAdd(&monos[pos].p, &p_coeff, &q_coeff);
+        }
+    }
+    *r = PolyOwnMonos(unique, monos);
+}
+
+/**
+ * Strumień jednomianów iloczynu @f$x_i \cdot y_i@f$ scalanych przez
+ * @ref DotHelper: jednomian @p a czynnika @f$x_i@f$ mnożony przez kolejne
+ * jednomiany @f$y_i@f$, zaczynając od jednomianu @p b.
+ */
+typedef struct {
+    poly_exp_t exp; ///< wykładnik bieżącego jednomianu strumienia
+    size_t pair; ///< indeks @f$i@f$ pary czynników
+    size_t a; ///< indeks jednomianu w @f$x_i@f$
+    size_t b; ///< indeks bieżącego jednomianu w @f$y_i@f$
+} MergeStream;
+
+/**
+ * Przywraca własność kopca (o najmniejszym wykładniku w korzeniu), przesuwając
+ * strumień z pozycji @p i w dół.
+ * @param[in,out] heap : kopiec strumieni
+ * @param[in] size : rozmiar kopca
+ * @param[in] i : pozycja przesuwanego strumienia
+ */
+static void MergeHeapDown(MergeStream *heap, size_t size, size_t i) {
+    MergeStream moved = heap[i];
+    while (2 * i + 1 < size) {
+        size_t child = 2 * i + 1;
+        if (child + 1 < size && heap[child + 1].exp < heap[child].exp)
+            child++;
+        if (heap[child].exp >= moved.exp)
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = moved;
+}
+
+/**
+ * Liczy @f$\sum_i x_i \cdot y_i@f$ jednym scalaniem k-drogowym. Dla każdego
+ * jednomianu każdego @f$x_i@f$ kopiec przechowuje strumień iloczynów tego
+ * jednomianu z kolejnymi jednomianami @f$y_i@f$. Iloczyny o tym samym
+ * wykładniku są zdejmowane z kopca razem, a ich współczynniki sumowane
+ * bezpośrednio (gdy są liczbami) lub rekurencyjnie tą samą metodą. Żadna suma
+ * częściowa nie jest tworzona.
+ * @param[in] count : liczba par czynników
+ * @param[in] x : tablica czynników @f$x_i@f$
+ * @param[in] y : tablica czynników @f$y_i@f$
+ * @return @f$\sum_i x_i \cdot y_i@f$
+ */
+static Poly DotHelper(size_t count, const Poly x[], const Poly y[]) {
+    if (count == 1)
+        return PolyMul(&x[0], &y[0]);
+
+    MonosView *views = malloc(2 * count * sizeof(MonosView));
+    if (views == NULL) exit(1);
+    MonosView *x_views = views, *y_views = views + count;
+    size_t streams = 0;
+    for (size_t i = 0; i < count; i++) {
+        /* Strumienie powstają dla jednomianów krótszego czynnika */
+        bool swap = PolySize(&x[i]) > PolySize(&y[i]);
+        MonosViewInit(&x_views[i], swap ? &y[i] : &x[i]);
+        MonosViewInit(&y_views[i], swap ? &x[i] : &y[i]);
+        if (y_views[i].size != 0)
+            streams += x_views[i].size;
+    }
+
+    /* Gdy wszystkie współczynniki są liczbami, a wykładniki leżą w niedużym
+     * przedziale, iloczyny są sumowane w tablicy indeksowanej wykładnikami */
+    bool flat = true;
+    size_t products = 0;
+    poly_exp_t min_exp = -1, max_exp = -1;
+    for (size_t i = 0; i < count && flat; i++) {
+        if (y_views[i].size == 0 || x_views[i].size == 0)
+            continue;
+        flat = x_views[i].values != NULL && y_views[i].values != NULL;
+        products += x_views[i].size * y_views[i].size;
+        poly_exp_t low = x_views[i].exps[0] + y_views[i].exps[0];
+        if (min_exp == -1 || low < min_exp)
+            min_exp = low;
+        max_exp = MaxExp(max_exp, x_views[i].exps[x_views[i].size - 1] +
+                                  y_views[i].exps[y_views[i].size - 1]);
+    }
+    if (flat && products != 0 &&
+        (size_t) (max_exp - min_exp) < LEAF_MUL_DENSE_FACTOR * products) {
+        size_t range = (size_t) (max_exp - min_exp) + 1;
+        poly_coeff_t *dense = calloc(range, sizeof(poly_coeff_t));
+        if (dense == NULL) exit(1);
+        for (size_t i = 0; i < count; i++) {
+            const MonosView *x_view = &x_views[i], *y_view = &y_views[i];
+            for (size_t a = 0; a < x_view->size; a++)
+                for (size_t b = 0; b < y_view->size; b++)
+                    dense[x_view->exps[a] + y_view->exps[b] - min_exp] +=
+                        x_view->values[a] * y_view->values[b];
+        }
+        free(views);
+        return LeafFromDense(dense, min_exp, range);
+    }
+
+    size_t capacity = streams == 0 ? 1 : streams;
+    MergeStream *heap = malloc(capacity * sizeof(MergeStream));
+    /* Współczynniki czynników iloczynów o wspólnym wykładniku */
+    Poly *x_group = malloc(2 * capacity * sizeof(Poly));
+    if (heap == NULL || x_group == NULL) exit(1);
+    Poly *y_group = x_group + capacity;
+    size_t heap_size = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (y_views[i].size == 0)
+            continue;
+        for (size_t a = 0; a < x_views[i].size; a++)
+            heap[heap_size++] = (MergeStream) {
+                .exp = x_views[i].exps[a] + y_views[i].exps[0], .pair = i, .a = a, .b = 0};
+    }
+    for (size_t i = heap_size / 2; i-- > 0;)
+        MergeHeapDown(heap, heap_size, i);
+
+    size_t size = 0;
+    Mono *monos = SafeMonoMalloc(capacity);
+    while (heap_size != 0) {
+        poly_exp_t exp = heap[0].exp;
+        poly_coeff_t constant = 0;
+        size_t group_size = 0;
+        flat = true;
+        do {
+            MergeStream *top = &heap[0];
+            const MonosView *x_view = &x_views[top->pair], *y_view = &y_views[top->pair];
+            if (x_view->values != NULL && y_view->values != NULL)
+                constant += x_view->values[top->a] * y_view->values[top->b];
+            else
+                flat = false;
+            x_group[group_size] = MonosViewCoeff(x_view, top->a);
+            y_group[group_size++] = MonosViewCoeff(y_view, top->b);
+
+            if (++top->b != y_view->size)
+                top->exp = x_view->exps[top->a] + y_view->exps[top->b];
+            else
+                *top = heap[--heap_size];
+            MergeHeapDown(heap, heap_size, 0);
+        } while (heap_size != 0 && heap[0].exp == exp);
+
+        Poly coeff = flat ? PolyFromCoeff(constant)
+                          : DotHelper(group_size, x_group, y_group);
+        if (PolyIsZero(&coeff))
+            continue;
+        if (size == capacity) {
+            capacity *= 2;
+            monos = realloc(monos, capacity * sizeof(Mono));
+            if (monos == NULL) exit(1);
+        }
+        monos[size++] = (Mono) {.p = coeff, .exp = exp};
+    }
+    free(x_group);
+    free(heap);
+    free(views);
+    return PolyOwnMonos(size, monos);
+}
+
+Poly PolyDotProduct(size_t count, const Poly p[], const Poly q[]) {
+    if (count == 0)
+        return PolyZero();
+    return DotHelper(count, p, q);
+}
+
+Poly PolyAddMany(size_t count, const Poly p[]) {
+    if (count == 0)
+        return PolyZero();
+    /* Suma to iloczyn skalarny z jedynkami - kopiec ma wtedy po jednym
+     * strumieniu na każdy wielomian */
+    Poly *ones = malloc(count * sizeof(Poly));
+    if (ones == NULL) exit(1);
+    for (size_t i = 0; i < count; i++)
+        ones[i] = PolyFromCoeff(1);
+    Poly result = DotHelper(count, ones, p);
+    free(ones);
+    return result;
+}
+
+Poly PolyLinearCombination(size_t count, const poly_coeff_t c[], const Poly p[]) {
+    if (count == 0)
+        return PolyZero();
+    Poly *constants = malloc(count * sizeof(Poly));
+    if (constants == NULL) exit(1);
+    for (size_t i = 0; i < count; i++)
+        constants[i] = PolyFromCoeff(c[i]);
+    Poly result = DotHelper(count, constants, p);
+    free(constants);
+    return result;
+}
+
+/**
+ * Sprawdza, czy wielomiany są tego samego rodzaju i mają równe współczynniki
+ * lub równe wykładniki jednomianów. Współczynniki jednomianów porównuje tylko
+ * w liściach.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return Czy wielomiany mogą być równe?
+ */
+static bool PolyShallowEq(const Poly *p, const Poly *q) {
+    if (PolyIsCoeff(p) != PolyIsCoeff(q) || PolyIsInline(p) != PolyIsInline(q))
+        return false;
+    if (PolyIsCoeff(p))
+        return p->coeff == q->coeff;
+    if (PolyIsInline(p))
+        return p->coeff == q->coeff && InlineExp(p) == InlineExp(q);
+    if (p->size != q->size || p->node->leaf != q->node->leaf ||
+        p->node->deg != q->node->deg ||
+        memcmp(p->node->exps, q->node->exps, p->size * sizeof(poly_exp_t)) != 0)
+        return false;
+    return !p->node->leaf ||
+           memcmp(PolyLeafCoeffs(p), PolyLeafCoeffs(q), p->size * sizeof(poly_coeff_t)) == 0;
+}
+
+bool PolyIsEq(const Poly *p, const Poly *q) {
+    if (!PolyShallowEq(p, q))
+        return false;
+    if (!PolyIsInner(p))
+        return true;
+
+    bool result = true;
+    WalkStack stack;
+    WalkStackInit(&stack);
+    WalkStackPush(&stack, p, PolyCoeffs(q));
+    while (result && stack.size != 0) {
+        WalkFrame *top = &stack.frames[stack.size - 1];
+        /* Porównuje współczynniki aż do pierwszego, w który trzeba zejść */
+        while (result && top->index != top->size) {
+            const Poly *p_coeff = &top->coeffs[top->index];
+            const Poly *q_coeff = &top->other[top->index];
+            if (!PolyShallowEq(p_coeff, q_coeff))
+                result = false;
+            else if (PolyIsInner(p_coeff))
+                break;
+            top->index++;
+        }
+        if (!result)
+            break;
+        if (top->index == top->size)
+            stack.size--;
+        else {
+            const Poly *p_coeff = &top->coeffs[top->index];
+            const Poly *q_coeff = &top->other[top->index++];
+            WalkStackPush(&stack, p_coeff, PolyCoeffs(q_coeff));
+        }
+    }
+    WalkStackFree(&stack);
+    return result;
+}
+
+/**
+ * Szybkie potęgowanie.
+ * @param[in] base : podstawa
+ * @param[in] exp : wykładnik
+ * @return @f$ base^{exp}@f$
+ */
+static poly_coeff_t QuickPow(poly_coeff_t base, poly_coeff_t exp) {
+    if (exp == 0)
+        return 1;
+    if (exp % 2 == 1)
         return base * QuickPow(base, exp - 1);
     poly_coeff_t result = QuickPow(base, exp / 2);
     return result * result;
 }
 
-Poly PolyAt(const Poly *p, poly_coeff_t x) {
-    if (PolyIsZero(p))
+/**
+ * Wylicza wartość wielomianu o liczbowych współczynnikach w punkcie @p x.
+ * Kolejne potęgi @p x są wyliczane na podstawie poprzednich.
+ * @param[in] p : widok wielomianu o liczbowych współczynnikach
+ * @param[in] x : wartość argumentu
+ * @return @f$p(x)@f$
+ */
+static poly_coeff_t LeafAt(const MonosView *p, poly_coeff_t x) {
+    const poly_exp_t *exps = p->exps;
+    const poly_coeff_t *coeffs = p->values;
+    poly_coeff_t power = QuickPow(x, exps[0]), result = 0;
+    for (size_t i = 0; i < p->size; i++) {
+        if (i != 0)
+            power *= QuickPow(x, exps[i] - exps[i - 1]);
+        result += coeffs[i] * power;
+    }
+    return result;
+}
+
+Poly PolyAt(const Poly *p, poly_coeff_t x) {
+    if (PolyIsZero(p))
+        return PolyZero();
+    if (PolyIsCoeff(p))
+        return PolyFromCoeff(p->coeff);
+    if (PolyIsFlat(p)) {
+        MonosView v;
+        MonosViewInit(&v, p);
+        return PolyFromCoeff(LeafAt(&v, x));
+    }
+
+    /* Wielomian, do którego są dodawane kolejne współczynniki po pomnożeniu przez x */
+    Poly result = PolyZero();
+    const Poly *coeffs = PolyCoeffs(p);
+    const poly_exp_t *exps = p->node->exps;
+    poly_coeff_t power = QuickPow(x, exps[0]);
+
+    for (size_t i = 0; i < p->size; i++) {
+        if (i != 0)
+            power *= QuickPow(x, exps[i] - exps[i - 1]);
+        Poly multiplied_poly = PolyMulByCoeff(&coeffs[i], power);
+
+        Poly prev_result = result;
+        result = PolyAdd(&result, &multiplied_poly);
+        PolyDestroy(&prev_result);
+        PolyDestroy(&multiplied_poly);
+    }
+    return result;
+}
+
+/**
+ * Wykonuje szybkie potęgowanie wielomianu do potęgi @p exp.
+ * @param[in] p : wielomian
+ * @param[in] exp : wykładnik potęgi
+ * @return wielomian będący wynikiem potęgowania
+ */
+static Poly QuickPolyPow(const Poly *p, poly_coeff_t exp) {
+    if (exp == 0)
+        return PolyFromCoeff(1);
+    if (exp % 2 == 1){
+        Poly res = QuickPolyPow(p, exp - 1);
+        Poly mul_res = PolyMul(p, &res);
+        PolyDestroy(&res);
+        return mul_res;
+    }
+
+    Poly result = QuickPolyPow(p, exp / 2);
+    Poly mul_res = PolyMul(&result, &result);
+    PolyDestroy(&result);
+    return mul_res;
+}
+
+/**
+ * Dokonuje rekurencyjnego składania wielomianów.
+ * @param p : wielomian
+ * @param poly_index : indeks wielomianu z tablicy @p q, od którego rozpoczynamy składanie
+ * @param size : rozmiar tablicy @p q
+ * @param q : tablica wielomianów
+ * @return
+ */
+Poly ComposeHelper(const Poly *p, long poly_index, const size_t size, const Poly q[]) {
+    if (PolyIsCoeff(p))
+        return PolyClone(p);
+
+    MonosView v;
+    MonosViewInit(&v, p);
+    const poly_exp_t *exps = v.exps;
+    poly_index++;
+    if (poly_index >= (long) size) {
+        /* Jednomian o wykładniku 0 może być tylko pierwszy */
+        if (exps[0] == 0) {
+            Poly coeff = MonosViewCoeff(&v, 0);
+            return ComposeHelper(&coeff, ++poly_index, size, q);
+        }
+        return PolyZero();
+    }
+
+    Poly result, acc = PolyZero();
+    for (size_t i = 0; i < v.size; i++) {
+        Poly coeff = MonosViewCoeff(&v, i);
+        result = ComposeHelper(&coeff, poly_index, size, q);
+        Poly pow_res = QuickPolyPow(&q[poly_index], exps[i]);
+        Poly mul_res = PolyMul(&result, &pow_res);
+        PolyDestroy(&pow_res);
+        PolyDestroy(&result);
+        Poly add_res = PolyAdd(&acc, &mul_res);
+        PolyDestroy(&mul_res);
+        Poly old_acc = acc;
+        acc = add_res;
+        PolyDestroy(&old_acc);
+    }
+    return acc;
+}
+
+static bool ComposeMonomials(const Poly *p, size_t k, const Poly q[], Poly *result);
+static bool ComposeAffine(const Poly *p, size_t k, const Poly q[], Poly *result);
+
+Poly PolyCompose(const Poly *p, size_t k, const Poly q[]) {
+    Poly result;
+    if (!PolyIsCoeff(p) && (ComposeMonomials(p, k, q, &result) ||
+                            ComposeAffine(p, k, q, &result)))
+        return result;
+    return ComposeHelper(p, COMPOSE_STARTING_INDEX, k, q);
+}
+
+Poly PolyTruncate(const Poly *p, poly_exp_t d) {
+    if (PolyDeg(p) <= d)
+        return PolyClone(p);
+    if (d < 0 || PolyIsInline(p))
+        return PolyZero();
+
+    /* Stopień wielomianu jest większy od d, więc d + 1 się nie przepełni */
+    MonosView v;
+    MonosViewInit(&v, p);
+    size_t count = GallopExps(v.exps, 0, v.size, d + 1);
+    if (v.values != NULL) {
+        PolyNode *node = LeafMalloc(count);
+        memcpy(node->exps, v.exps, count * sizeof(poly_exp_t));
+        memcpy(LeafCoeffs(node, count), v.values, count * sizeof(poly_coeff_t));
+        return PolyFromLeaf(node, count, count);
+    }
+
+    PolyNode *node = NodeMalloc(count);
+    Poly *coeffs = NodeCoeffs(node, count);
+    size_t index = 0;
+    for (size_t i = 0; i < count; i++) {
+        Poly truncated = PolyTruncate(&v.coeffs[i], d - v.exps[i]);
+        if (!PolyIsZero(&truncated)) {
+            node->exps[index] = v.exps[i];
+            coeffs[index++] = truncated;
+        }
+    }
+    return PolyFromNode(node, count, index);
+}
+
+/**
+ * Przesuwa koniec przedziału jednomianów @p q, których iloczyn z jednomianem
+ * o wykładniku @p exp ma wykładnik nie większy od @p d. Dla rosnących
+ * wykładników @p exp koniec przedziału tylko maleje, więc wszystkie
+ * przesunięcia kosztują łącznie @f$O(m)@f$ dla @f$m@f$ jednomianów @p q.
+ * @param[in] q : widok wielomianu
+ * @param[in] end : poprzedni koniec przedziału
+ * @param[in] exp : wykładnik jednomianu drugiego czynnika
+ * @param[in] d : ograniczenie wykładnika iloczynu
+ * @return nowy koniec przedziału
+ */
+static size_t TruncEnd(const MonosView *q, size_t end, poly_exp_t exp, poly_exp_t d) {
+    while (end > 0 && q->exps[end - 1] > d - exp)
+        end--;
+    return end;
+}
+
+/**
+ * Mnoży dwa wielomiany o liczbowych współczynnikach, pomijając iloczyny
+ * jednomianów o wykładniku większym od @p d. Dzięki posortowaniu wykładników
+ * pętla wewnętrzna kończy się na pierwszym zbyt dużym wykładniku, a pętla
+ * zewnętrzna - gdy żaden jednomian @p q nie pasuje. Iloczyny są sumowane tak
+ * jak w @ref LeafMul.
+ * @param[in] p : widok wielomianu o liczbowych współczynnikach
+ * @param[in] q : widok wielomianu o liczbowych współczynnikach
+ * @param[in] d : nieujemne ograniczenie stopnia
+ * @return @f$p \cdot q@f$ obcięty do stopnia @p d
+ */
+static Poly LeafMulTrunc(const MonosView *p, const MonosView *q, poly_exp_t d) {
+    const poly_exp_t *p_exps = p->exps, *q_exps = q->exps;
+    const poly_coeff_t *p_coeffs = p->values, *q_coeffs = q->values;
+    size_t pairs = 0, end = q->size;
+    poly_exp_t min_exp = p_exps[0] + q_exps[0], max_exp = min_exp;
+    for (size_t i = 0; i < p->size; i++) {
+        end = TruncEnd(q, end, p_exps[i], d);
+        if (end == 0)
+            break;
+        pairs += end;
+        max_exp = MaxExp(max_exp, p_exps[i] + q_exps[end - 1]);
+    }
+    if (pairs == 0)
+        return PolyZero();
+
+    size_t range = (size_t) (max_exp - min_exp) + 1;
+    if (range > LEAF_MUL_DENSE_FACTOR * pairs) {
+        Mono *products = SafeMonoMalloc(pairs);
+        size_t index = 0;
+        end = q->size;
+        for (size_t i = 0; i < p->size && (end = TruncEnd(q, end, p_exps[i], d)) > 0; i++)
+            for (size_t j = 0; j < end; j++)
+                products[index++] = (Mono) {
+                    .p = PolyFromCoeff(p_coeffs[i] * q_coeffs[j]),
+                    .exp = p_exps[i] + q_exps[j]};
+        return PolyOwnMonos(pairs, products);
+    }
+
+    poly_coeff_t *dense = calloc(range, sizeof(poly_coeff_t));
+    if (dense == NULL) exit(1);
+    end = q->size;
+    for (size_t i = 0; i < p->size && (end = TruncEnd(q, end, p_exps[i], d)) > 0; i++)
+        for (size_t j = 0; j < end; j++)
+            dense[p_exps[i] + q_exps[j] - min_exp] += p_coeffs[i] * q_coeffs[j];
+    return LeafFromDense(dense, min_exp, range);
+}
+
+/**
+ * Mnoży dwa wielomiany, które nie są współczynnikami, pomijając iloczyny
+ * jednomianów o wykładniku większym od @p d, a współczynniki pozostałych
+ * iloczynów mnoży z ograniczeniem stopnia pomniejszonym o ten wykładnik.
+ * @param[in] p : widok wielomianu @f$p@f$
+ * @param[in] q : widok wielomianu @f$q@f$
+ * @param[in] d : nieujemne ograniczenie stopnia
+ * @return @f$p \cdot q@f$ obcięty do stopnia @p d
+ */
+static Poly MulNodesTrunc(const MonosView *p, const MonosView *q, poly_exp_t d) {
+    size_t pairs = 0, end = q->size;
+    for (size_t i = 0; i < p->size && (end = TruncEnd(q, end, p->exps[i], d)) > 0; i++)
+        pairs += end;
+    if (pairs == 0)
+        return PolyZero();
+
+    Mono *products = SafeMonoMalloc(pairs);
+    size_t index = 0;
+    end = q->size;
+    for (size_t i = 0; i < p->size && (end = TruncEnd(q, end, p->exps[i], d)) > 0; i++) {
+        Poly p_coeff = MonosViewCoeff(p, i);
+        for (size_t j = 0; j < end; j++) {
+            Poly q_coeff = MonosViewCoeff(q, j);
+            poly_exp_t exp = p->exps[i] + q->exps[j];
+            products[index++] = (Mono) {.p = PolyMulTrunc(&p_coeff, &q_coeff, d - exp),
+                                        .exp = exp};
+        }
+    }
+    return PolyOwnMonos(pairs, products);
+}
+
+Poly PolyMulTrunc(const Poly *p, const Poly *q, poly_exp_t d) {
+    if (PolyIsZero(p) || PolyIsZero(q) || d < 0)
+        return PolyZero();
+    /* Stopnie są zapamiętane w węzłach, więc sprawdzenie, czy cokolwiek
+     * trzeba obcinać, nie kosztuje przejścia drzewa */
+    if ((long long) PolyDeg(p) + PolyDeg(q) <= d)
+        return PolyMul(p, q);
+
+    if (PolyIsCoeff(p) || PolyIsCoeff(q)) {
+        Poly truncated = PolyTruncate(PolyIsCoeff(p) ? q : p, d);
+        Poly result = PolyMulByCoeff(&truncated, PolyIsCoeff(p) ? p->coeff : q->coeff);
+        PolyDestroy(&truncated);
+        return result;
+    }
+
+    MonosView p_view, q_view;
+    MonosViewInit(&p_view, p);
+    MonosViewInit(&q_view, q);
+    if (PolyIsFlat(p) && PolyIsFlat(q))
+        return LeafMulTrunc(&p_view, &q_view, d);
+    return MulNodesTrunc(&p_view, &q_view, d);
+}
+
+Poly PolyPowTrunc(const Poly *p, poly_exp_t n, poly_exp_t d) {
+    assert(n >= 0);
+    Poly result = PolyFromCoeff(d < 0 ? 0 : 1);
+    Poly base = PolyTruncate(p, d);
+    while (n > 0 && !PolyIsZero(&result)) {
+        if (n % 2 == 1) {
+            Poly product = PolyMulTrunc(&result, &base, d);
+            PolyDestroy(&result);
+            result = product;
+        }
+        n /= 2;
+        if (n > 0) {
+            Poly square = PolyMulTrunc(&base, &base, d);
+            PolyDestroy(&base);
+            base = square;
+        }
+    }
+    PolyDestroy(&base);
+    return result;
+}
+
+/**
+ * Składa wielomiany z tablicy @p q do wielomianu zmiennej @f$x_{index}@f$,
+ * obcinając wszystkie wyniki pośrednie do stopnia @p d. Potęgi
+ * @f$q_{index}@f$ są liczone przyrostowo dla kolejnych wykładników, a gdy
+ * obcięta potęga staje się zerem, pozostałe jednomiany są pomijane.
+ * @param[in] p : wielomian
+ * @param[in] index : indeks zmiennej głównej @p p
+ * @param[in] k : liczba wielomianów w tablicy @p q
+ * @param[in] q : tablica wielomianów
+ * @param[in] d : nieujemne ograniczenie stopnia
+ * @return złożenie obcięte do stopnia @p d
+ */
+static Poly ComposeTruncHelper(const Poly *p, size_t index, size_t k, const Poly q[],
+                               poly_exp_t d) {
+    if (PolyIsCoeff(p))
+        return PolyClone(p);
+
+    MonosView v;
+    MonosViewInit(&v, p);
+    /* Za zmienne bez wielomianu w q jest podstawiane zero */
+    if (index >= k) {
+        if (v.exps[0] != 0)
+            return PolyZero();
+        Poly coeff = MonosViewCoeff(&v, 0);
+        return ComposeTruncHelper(&coeff, index + 1, k, q, d);
+    }
+
+    Poly *terms = malloc(v.size * sizeof(Poly));
+    if (terms == NULL) exit(1);
+    Poly power = PolyFromCoeff(1);
+    size_t count = 0;
+    for (size_t i = 0; i < v.size; i++) {
+        poly_exp_t gap = v.exps[i] - (i == 0 ? 0 : v.exps[i - 1]);
+        if (gap > 0) {
+            Poly gap_power = PolyPowTrunc(&q[index], gap, d);
+            Poly next = PolyMulTrunc(&power, &gap_power, d);
+            PolyDestroy(&gap_power);
+            PolyDestroy(&power);
+            power = next;
+        }
+        /* Wyższe potęgi też są obcinane do zera */
+        if (PolyIsZero(&power))
+            break;
+        Poly coeff = MonosViewCoeff(&v, i);
+        Poly sub = ComposeTruncHelper(&coeff, index + 1, k, q, d);
+        terms[count++] = PolyMulTrunc(&sub, &power, d);
+        PolyDestroy(&sub);
+    }
+    PolyDestroy(&power);
+    if (count == 0) {
+        free(terms);
+        return PolyZero();
+    }
+    Poly result = PolyAddMany(count, terms);
+    for (size_t i = 0; i < count; i++)
+        PolyDestroy(&terms[i]);
+    free(terms);
+    return result;
+}
+
+Poly PolyComposeTrunc(const Poly *p, size_t k, const Poly q[], poly_exp_t d) {
+    if (d < 0)
+        return PolyZero();
+    /* Złożenie ma stopień nie większy niż deg p razy największy ze stopni
+     * q_i, a wtedy nie ma czego obcinać */
+    poly_exp_t max_deg = 0;
+    for (size_t i = 0; i < k; i++)
+        max_deg = MaxExp(max_deg, PolyDeg(&q[i]));
+    if ((long long) PolyDeg(p) * max_deg <= d)
+        return PolyCompose(p, k, q);
+    return ComposeTruncHelper(p, 0, k, q, d);
+}
+
+/** Zakresy wykładników nie większe od tej wartości są przesuwane schematem
+ *  Hornera, a większe dzielone na pół. */
+#define TAYLOR_SHIFT_HORNER_RANGE 32
+
+/** Liczba potęg @f$(x + a)^{2^t}@f$, które mogą być potrzebne przy
+ *  przesuwaniu wielomianu. */
+#define TAYLOR_SHIFT_POWERS 32
+
+/**
+ * Daje potęgę @f$(x + a)^{2^t}@f$, obliczając ją przy pierwszym użyciu
+ * przez podnoszenie do kwadratu potęgi poprzedniej.
+ * @param[in,out] powers : obliczone potęgi, niepoliczone są zerowe
+ * @param[in] t : wykładnik potęgi dwójki
+ * @param[in] a : przesunięcie
+ * @return wskaźnik na potęgę należącą do tablicy @p powers
+ */
+static const Poly *ShiftPower(Poly powers[], unsigned t, poly_coeff_t a) {
+    if (PolyIsZero(&powers[t])) {
+        if (t == 0) {
+            Poly x = PolyFromTerm(1, 1);
+            powers[0] = PolyAddCoeff(&x, a);
+        }
+        else {
+            const Poly *half = ShiftPower(powers, t - 1, a);
+            powers[t] = PolyMul(half, half);
+        }
+    }
+    return &powers[t];
+}
+
+/**
+ * Przesuwa zmienną główną wielomianu złożonego z jednomianów widoku
+ * o indeksach od @p from do @p to - 1, z wykładnikami pomniejszonymi
+ * o @p base. Mały zakres wykładników jest przesuwany schematem Hornera
+ * w tablicy indeksowanej wykładnikami, a duży dzielony: dla
+ * @f$p = p_0 + x^h p_1@f$ wynikiem jest
+ * @f$p_0(x + a) + (x + a)^h \cdot p_1(x + a)@f$, gdzie @f$h@f$ jest potęgą dwójki.
+ * @param[in] v : widok wielomianu
+ * @param[in] from : indeks pierwszego jednomianu
+ * @param[in] to : indeks za ostatnim jednomianem
+ * @param[in] base : wykładnik odejmowany od wykładników jednomianów
+ * @param[in] a : przesunięcie
+ * @param[in,out] powers : potęgi @f$(x + a)^{2^t}@f$ dla @ref ShiftPower
+ * @return przesunięty wielomian
+ */
+static Poly ShiftRange(const MonosView *v, size_t from, size_t to, poly_exp_t base,
+                       poly_coeff_t a, Poly powers[]) {
+    size_t range = (size_t) (v->exps[to - 1] - base) + 1;
+    if (range <= TAYLOR_SHIFT_HORNER_RANGE) {
+        Mono *monos = SafeMonoMalloc(range);
+        for (size_t e = 0; e < range; e++)
+            monos[e] = (Mono) {.p = PolyZero(), .exp = (poly_exp_t) e};
+        for (size_t i = from; i < to; i++) {
+            Poly coeff = MonosViewCoeff(v, i);
+            monos[v->exps[i] - base].p = PolyClone(&coeff);
+        }
+        Poly shift = PolyFromCoeff(a);
+        for (size_t i = 0; i + 1 < range; i++)
+            for (size_t j = range - 1; j-- > i;)
+                PolyMulAdd(&monos[j].p, &shift, &monos[j + 1].p);
+        return PolyOwnMonos(range, monos);
+    }
+
+    unsigned t = 0;
+    while (((size_t) 2 << t) < range)
+        t++;
+    poly_exp_t half = (poly_exp_t) 1 << t;
+    size_t mid = GallopExps(v->exps, from, to, base + half);
+    Poly low = mid > from ? ShiftRange(v, from, mid, base, a, powers) : PolyZero();
+    Poly high = ShiftRange(v, mid, to, base + half, a, powers);
+    PolyMulAdd(&low, ShiftPower(powers, t, a), &high);
+    PolyDestroy(&high);
+    return low;
+}
+
+/**
+ * Podstawia @f$x + a@f$ za zmienną główną wielomianu (przesunięcie Taylora).
+ * Wielomian o liczbowych współczynnikach jest przesuwany w miejscu schematem
+ * Hornera w czasie @f$O(n^2)@f$ dla stopnia @f$n@f$, a pozostałe dzielone
+ * przez @ref ShiftRange, co wymaga tylko @f$O(n)@f$ działań na współczynnikach.
+ * @param[in] p : wielomian
+ * @param[in] a : przesunięcie
+ * @return @f$p(x + a)@f$
+ */
+static Poly TaylorShift(const Poly *p, poly_coeff_t a) {
+    if (a == 0 || PolyIsCoeff(p))
+        return PolyClone(p);
+
+    MonosView v;
+    MonosViewInit(&v, p);
+    if (v.values != NULL) {
+        size_t range = (size_t) v.exps[v.size - 1] + 1;
+        poly_coeff_t *dense = calloc(range, sizeof(poly_coeff_t));
+        if (dense == NULL) exit(1);
+        for (size_t i = 0; i < v.size; i++)
+            dense[v.exps[i]] = v.values[i];
+        for (size_t i = 0; i + 1 < range; i++)
+            for (size_t j = range - 1; j-- > i;)
+                dense[j] += a * dense[j + 1];
+        return LeafFromDense(dense, 0, range);
+    }
+
+    Poly powers[TAYLOR_SHIFT_POWERS];
+    for (size_t t = 0; t < TAYLOR_SHIFT_POWERS; t++)
+        powers[t] = PolyZero();
+    Poly result = ShiftRange(&v, 0, v.size, 0, a, powers);
+    for (size_t t = 0; t < TAYLOR_SHIFT_POWERS; t++)
+        PolyDestroy(&powers[t]);
+    return result;
+}
+
+/**
+ * Przesuwa zmienną na głębokości @p depth, przepisując poziomy powyżej niej.
+ * @param[in] p : wielomian
+ * @param[in] depth : głębokość zmiennej względem @p p
+ * @param[in] a : przesunięcie
+ * @return wielomian po podstawieniu @f$x + a@f$ za zmienną
+ */
+static Poly ShiftHelper(const Poly *p, size_t depth, poly_coeff_t a) {
+    if (PolyIsCoeff(p) || (depth > 0 && PolyIsFlat(p)))
+        return PolyClone(p);
+    if (depth == 0)
+        return TaylorShift(p, a);
+
+    const Poly *children = PolyCoeffs(p);
+    Mono *monos = SafeMonoMalloc(p->size);
+    for (size_t i = 0; i < p->size; i++)
+        monos[i] = (Mono) {.p = ShiftHelper(&children[i], depth - 1, a),
+                           .exp = p->node->exps[i]};
+    return PolyOwnMonos(p->size, monos);
+}
+
+Poly PolyShift(const Poly *p, size_t var_idx, poly_coeff_t a) {
+    return ShiftHelper(p, var_idx, a);
+}
+
+/**
+ * Sprawdza, czy wielomian jest postaci @f$x_0 + a@f$.
+ * @param[in] q : wielomian
+ * @param[out] a : wyraz wolny @f$a@f$
+ * @return Czy wielomian jest postaci @f$x_0 + a@f$?
+ */
+static bool PolyIsShiftedVar(const Poly *q, poly_coeff_t *a) {
+    if (!PolyIsFlat(q))
+        return false;
+    MonosView v;
+    MonosViewInit(&v, q);
+    size_t last = v.size - 1;
+    if (v.size > 2 || v.exps[last] != 1 || v.values[last] != 1 ||
+        (v.size == 2 && v.exps[0] != 0))
+        return false;
+    *a = v.size == 2 ? v.values[0] : 0;
+    return true;
+}
+
+/**
+ * Zanurza wielomian o @p levels poziomów głębiej, czyli tworzy wielomian
+ * @f$p(x_{levels}, x_{levels + 1}, \ldots)@f$. Przejmuje @p p na własność.
+ * @param[in] p : wielomian
+ * @param[in] levels : liczba poziomów
+ * @return zanurzony wielomian
+ */
+static Poly PolyLift(Poly p, size_t levels) {
+    for (size_t i = 0; i < levels && !PolyIsCoeff(&p); i++) {
+        Mono *mono = SafeMonoMalloc(1);
+        mono[0] = (Mono) {.p = p, .exp = 0};
+        p = PolyOwnMonos(1, mono);
+    }
+    return p;
+}
+
+/**
+ * Oblicza schematem Hornera @f$\sum_j c_j \cdot q^{e_j}@f$ dla jednomianów
+ * @f$c_j x^{e_j}@f$ wielomianu @p p, zanurzając współczynniki @f$c_j@f$
+ * o @p levels poziomów.
+ * @param[in] p : wielomian, który nie jest współczynnikiem
+ * @param[in] levels : liczba poziomów, o którą są zanurzane współczynniki
+ * @param[in] q : wielomian podstawiany za zmienną główną @p p
+ * @return @f$\sum_j c_j \cdot q^{e_j}@f$
+ */
+static Poly SubstituteMainVar(const Poly *p, size_t levels, const Poly *q) {
+    MonosView v;
+    MonosViewInit(&v, p);
+    size_t last = v.size - 1;
+    Poly coeff = MonosViewCoeff(&v, last);
+    Poly acc = PolyLift(PolyClone(&coeff), levels);
+    for (size_t i = last; i-- > 0;) {
+        coeff = MonosViewCoeff(&v, i);
+        Poly sum = PolyLift(PolyClone(&coeff), levels);
+        Poly pow = QuickPolyPow(q, v.exps[i + 1] - v.exps[i]);
+        PolyMulAdd(&sum, &acc, &pow);
+        PolyDestroy(&pow);
+        PolyDestroy(&acc);
+        acc = sum;
+    }
+    if (v.exps[0] == 0)
+        return acc;
+    Poly pow = QuickPolyPow(q, v.exps[0]);
+    Poly result = PolyMul(&acc, &pow);
+    PolyDestroy(&pow);
+    PolyDestroy(&acc);
+    return result;
+}
+
+/**
+ * Podstawia wielomian za zmienną na głębokości @p depth, gdy podstawiany
+ * wielomian nie zależy od zmiennych wyższych poziomów. Poziomy powyżej
+ * @p depth są przepisywane bez obliczeń, a poddrzewa bez tej zmiennej
+ * kopiowane.
+ * @param[in] p : wielomian
+ * @param[in] depth : głębokość zmiennej względem @p p
+ * @param[in] q : wielomian zmiennych od głębokości @p depth
+ * @return wynik podstawienia, w tym samym układzie zmiennych co @p p
+ */
+static Poly SubstituteShifted(const Poly *p, size_t depth, const Poly *q) {
+    if (PolyIsCoeff(p) || (depth > 0 && PolyIsFlat(p)))
+        return PolyClone(p);
+    poly_coeff_t a;
+    if (depth == 0 && PolyIsShiftedVar(q, &a))
+        return TaylorShift(p, a);
+    if (depth == 0)
+        return SubstituteMainVar(p, 1, q);
+
+    const Poly *children = PolyCoeffs(p);
+    Mono *monos = SafeMonoMalloc(p->size);
+    for (size_t i = 0; i < p->size; i++)
+        monos[i] = (Mono) {.p = SubstituteShifted(&children[i], depth - 1, q),
+                           .exp = p->node->exps[i]};
+    return PolyOwnMonos(p->size, monos);
+}
+
+/**
+ * Podstawia wielomian za zmienną @f$x_{var\_idx}@f$ w ogólnym przypadku, gdy
+ * podstawiany wielomian może zależeć od zmiennych @f$x_0, \ldots, x_{level - 1}@f$.
+ * Wyniki są wyrażone w zmiennych bezwzględnych i mnożone przez jednomiany
+ * poziomów powyżej @p var_idx.
+ * @param[in] p : wielomian zmiennych @f$x_{level}, x_{level + 1}, \ldots@f$
+ * @param[in] level : poziom wielomianu @p p
+ * @param[in] var_idx : indeks zmiennej
+ * @param[in] q : podstawiany wielomian
+ * @return wynik podstawienia w zmiennych @f$x_0, x_1, \ldots@f$
+ */
+static Poly SubstituteAbsolute(const Poly *p, size_t level, size_t var_idx, const Poly *q) {
+    if (PolyIsCoeff(p) || (level < var_idx && PolyIsFlat(p)))
+        return PolyLift(PolyClone(p), level);
+    if (level == var_idx)
+        return SubstituteMainVar(p, level + 1, q);
+
+    MonosView v;
+    MonosViewInit(&v, p);
+    Poly *terms = malloc(v.size * sizeof(Poly));
+    if (terms == NULL) exit(1);
+    for (size_t i = 0; i < v.size; i++) {
+        Poly coeff = MonosViewCoeff(&v, i);
+        Poly sub = SubstituteAbsolute(&coeff, level + 1, var_idx, q);
+        Poly mono = PolyLift(PolyFromTerm(1, v.exps[i]), level);
+        terms[i] = PolyMul(&mono, &sub);
+        PolyDestroy(&mono);
+        PolyDestroy(&sub);
+    }
+    Poly result = PolyAddMany(v.size, terms);
+    for (size_t i = 0; i < v.size; i++)
+        PolyDestroy(&terms[i]);
+    free(terms);
+    return result;
+}
+
+Poly PolySubstitute(const Poly *p, size_t var_idx, const Poly *q) {
+    /* Jeśli q nie zależy od x_0, ..., x_{var_idx - 1}, to jest zanurzeniem
+     * wielomianu, który można podstawić bez zmiany układu zmiennych */
+    const Poly *shifted = q;
+    size_t depth = 0;
+    while (depth < var_idx && PolyIsInner(shifted) && shifted->size == 1 &&
+           shifted->node->exps[0] == 0) {
+        shifted = &PolyCoeffs(shifted)[0];
+        depth++;
+    }
+    if (depth == var_idx || PolyIsCoeff(shifted))
+        return SubstituteShifted(p, var_idx, shifted);
+    return SubstituteAbsolute(p, 0, var_idx, q);
+}
+
+/**
+ * Wylicza wartość wielomianu zmiennych @f$x_{level}, x_{level + 1}, \ldots@f$
+ * w punktach @p values dla zmiennych o indeksach z @p vars. Pozostałe
+ * zmienne są przenumerowywane kolejno, od najmniejszego indeksu.
+ * @param[in] p : wielomian
+ * @param[in] level : indeks zmiennej głównej @p p
+ * @param[in] k : liczba pozostałych do ustalenia zmiennych
+ * @param[in] vars : rosnące indeksy pozostałych do ustalenia zmiennych
+ * @param[in] values : wartości tych zmiennych
+ * @return wielomian pozostałych zmiennych
+ */
+static Poly AtManyHelper(const Poly *p, size_t level, size_t k, const size_t *vars,
+                         const poly_coeff_t *values) {
+    if (k == 0 || PolyIsCoeff(p))
+        return PolyClone(p);
+
+    MonosView v;
+    MonosViewInit(&v, p);
+    if (vars[0] != level) {
+        if (v.values != NULL)
+            return PolyClone(p);
+        Mono *monos = SafeMonoMalloc(v.size);
+        for (size_t i = 0; i < v.size; i++)
+            monos[i] = (Mono) {.p = AtManyHelper(&v.coeffs[i], level + 1, k, vars, values),
+                               .exp = v.exps[i]};
+        return PolyOwnMonos(v.size, monos);
+    }
+
+    if (v.values != NULL)
+        return PolyFromCoeff(LeafAt(&v, values[0]));
+    poly_coeff_t *powers = malloc(v.size * sizeof(poly_coeff_t));
+    if (powers == NULL) exit(1);
+    for (size_t i = 0; i < v.size; i++)
+        powers[i] = i == 0 ? QuickPow(values[0], v.exps[0])
+                           : powers[i - 1] * QuickPow(values[0], v.exps[i] - v.exps[i - 1]);
+    /* Gdy nie ma głębszych zmiennych do ustalenia, współczynniki są
+     * sumowane bezpośrednio z węzła */
+    if (k == 1) {
+        Poly result = PolyLinearCombination(v.size, powers, v.coeffs);
+        free(powers);
+        return result;
+    }
+    Poly *children = malloc(v.size * sizeof(Poly));
+    if (children == NULL) exit(1);
+    for (size_t i = 0; i < v.size; i++)
+        children[i] = AtManyHelper(&v.coeffs[i], level + 1, k - 1, vars + 1, values + 1);
+    Poly result = PolyLinearCombination(v.size, powers, children);
+    for (size_t i = 0; i < v.size; i++)
+        PolyDestroy(&children[i]);
+    free(children);
+    free(powers);
+    return result;
+}
+
+Poly PolyAtMany(const Poly *p, size_t k, const size_t vars[], const poly_coeff_t values[]) {
+    for (size_t i = 1; i < k; i++)
+        assert(vars[i - 1] < vars[i]);
+    return AtManyHelper(p, 0, k, vars, values);
+}
+
+/**
+ * Mnoży wielomian przez liczbę @p c i zwiększa wykładniki jego jednomianów
+ * o @p e, czyli mnoży go przez @f$c \cdot x^e@f$ dla jego zmiennej głównej.
+ * Korzysta z węzłów wielomianu, który przejmuje na własność, usuwając z nich
+ * tylko jednomiany wyzerowane przez przepełnienie. Dla @f$c = 1@f$ nie
+ * schodzi do współczynników.
+ * @param[in] p : wielomian
+ * @param[in] e : wykładnik
+ * @param[in] c : niezerowy współczynnik
+ * @return @f$p \cdot c \cdot x^e@f$
+ */
+static Poly ScaleOwned(Poly p, poly_exp_t e, poly_coeff_t c) {
+    if (PolyIsCoeff(&p))
+        return PolyFromTerm(p.coeff * c, e);
+    if (PolyIsInline(&p))
+        return PolyFromTerm(p.coeff * c, InlineExp(&p) + e);
+
+    PolyNode *node = p.node;
+    size_t index = 0;
+    if (node->leaf) {
+        poly_coeff_t *coeffs = LeafCoeffs(node, p.size);
+        for (size_t i = 0; i < p.size; i++) {
+            poly_coeff_t product = coeffs[i] * c;
+            if (product != 0) {
+                node->exps[index] = node->exps[i] + e;
+                coeffs[index++] = product;
+            }
+        }
+        return PolyFromLeaf(node, p.size, index);
+    }
+
+    Poly *coeffs = NodeCoeffs(node, p.size);
+    for (size_t i = 0; i < p.size; i++) {
+        Poly product = c == 1 ? coeffs[i] : ScaleOwned(coeffs[i], 0, c);
+        /* Przy mnożeniu czegoś niezerowego mogło dojść do overflow */
+        if (!PolyIsZero(&product)) {
+            node->exps[index] = node->exps[i] + e;
+            coeffs[index++] = product;
+        }
+    }
+    return PolyFromNode(node, p.size, index);
+}
+
+/**
+ * Mnoży wielomian zmiennych @f$x_{level}, x_{level + 1}, \ldots@f$ przez
+ * @f$c \cdot x_{level + depth}^e@f$. Przejmuje @p p na własność i korzysta
+ * z jego węzłów. Nowe węzły powstają tylko w miejsce liści i jednomianów
+ * przechowywanych bez węzła leżących powyżej zmiennej oraz dla zanurzanych
+ * współczynników.
+ * @param[in] p : wielomian
+ * @param[in] depth : głębokość zmiennej względem @p p
+ * @param[in] e : wykładnik
+ * @param[in] c : niezerowy współczynnik
+ * @return @f$p \cdot c \cdot x_{level + depth}^e@f$
+ */
+static Poly MulMonoHelper(Poly p, size_t depth, poly_exp_t e, poly_coeff_t c) {
+    if (depth == 0)
+        return ScaleOwned(p, e, c);
+    if (PolyIsCoeff(&p))
+        return PolyLift(PolyFromTerm(p.coeff * c, e), depth);
+
+    if (PolyIsInner(&p)) {
+        Poly *coeffs = PolyCoeffs(&p);
+        size_t index = 0;
+        for (size_t i = 0; i < p.size; i++) {
+            Poly product = MulMonoHelper(coeffs[i], depth - 1, e, c);
+            if (!PolyIsZero(&product)) {
+                p.node->exps[index] = p.node->exps[i];
+                coeffs[index++] = product;
+            }
+        }
+        return PolyFromNode(p.node, p.size, index);
+    }
+
+    /* Liczbowe współczynniki muszą się stać wielomianami, więc liść jest
+     * zastępowany węzłem */
+    MonosView v;
+    MonosViewInit(&v, &p);
+    PolyNode *node = NodeMalloc(v.size);
+    Poly *coeffs = NodeCoeffs(node, v.size);
+    size_t index = 0;
+    for (size_t i = 0; i < v.size; i++) {
+        Poly product = MulMonoHelper(MonosViewCoeff(&v, i), depth - 1, e, c);
+        if (!PolyIsZero(&product)) {
+            node->exps[index] = v.exps[i];
+            coeffs[index++] = product;
+        }
+    }
+    Poly result = PolyFromNode(node, v.size, index);
+    PolyDestroy(&p);
+    return result;
+}
+
+void PolyMulMono(Poly *p, size_t var_idx, poly_exp_t e, poly_coeff_t c) {
+    assert(e >= 0);
+    if (c == 0) {
+        PolyDestroy(p);
+        *p = PolyZero();
+    }
+    else if (c != 1 || e != 0) {
+        *p = MulMonoHelper(*p, var_idx, e, c);
+    }
+}
+
+/** Wyłączne górne ograniczenie modułu w działaniach na szeregach. */
+#define SERIES_MODULUS_LIMIT ((poly_coeff_t) 1 << 31)
+
+/** Liczba bitów młodszej połowy współczynnika przy mnożeniu szeregów
+ *  z podziałem współczynników (patrz @ref SeriesMul). */
+#define SERIES_SPLIT_BITS 16
+
+/**
+ * Sprowadza liczbę do przedziału @f$[0, m)@f$.
+ * @param[in] c : liczba
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @return @f$c \bmod m@f$ lub @p c, jeśli @f$m = 0@f$
+ */
+static poly_coeff_t ModReduce(poly_coeff_t c, poly_coeff_t m) {
+    if (m == 0)
+        return c;
+    c %= m;
+    return c < 0 ? c + m : c;
+}
+
+/**
+ * Wylicza odwrotność liczby w pierścieniu współczynników. Modulo
+ * @f$2^{64}@f$ odwracalne są liczby nieparzyste, a ich odwrotność jest
+ * liczona metodą Newtona, podwajającą liczbę poprawnych bitów.
+ * @param[in] c : liczba
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @param[out] inv : odwrotność
+ * @return Czy liczba jest odwracalna?
+ */
+static bool CoeffInverse(poly_coeff_t c, poly_coeff_t m, poly_coeff_t *inv) {
+    if (m == 0) {
+        if (c % 2 == 0)
+            return false;
+        /* Każda liczba nieparzysta jest swoją odwrotnością modulo 8 */
+        unsigned long x = c;
+        for (int bits = 3; bits < 64; bits *= 2)
+            x *= 2 - (unsigned long) c * x;
+        *inv = (poly_coeff_t) x;
+        return true;
+    }
+
+    poly_coeff_t r = ModReduce(c, m), next_r = m, s = 1, next_s = 0;
+    while (next_r != 0) {
+        poly_coeff_t q = r / next_r, t = r - q * next_r;
+        r = next_r;
+        next_r = t;
+        t = s - q * next_s;
+        s = next_s;
+        next_s = t;
+    }
+    if (r != 1)
+        return false;
+    *inv = ModReduce(s, m);
+    return true;
+}
+
+/**
+ * Daje współczynniki wielomianu o liczbowych współczynnikach przy
+ * @f$x^0, \ldots, x^{n-1}@f$.
+ * @param[in] p : wielomian o liczbowych współczynnikach
+ * @param[in] n : liczba współczynników
+ * @return tablica współczynników zaalokowana na stercie
+ */
+static poly_coeff_t *SeriesToDense(const Poly *p, poly_exp_t n) {
+    poly_coeff_t *dense = calloc(n, sizeof(poly_coeff_t));
+    if (dense == NULL) exit(1);
+    MonosView v;
+    MonosViewInit(&v, p);
+    for (size_t i = 0; i < v.size && v.exps[i] < n; i++)
+        dense[v.exps[i]] = v.values[i];
+    return dense;
+}
+
+/**
+ * Tworzy wielomian ze współczynników przy @f$x^0, \ldots, x^{n-1}@f$, nie
+ * zwalniając tablicy.
+ * @param[in] dense : tablica współczynników
+ * @param[in] n : liczba współczynników
+ * @return wielomian
+ */
+static Poly SeriesToPoly(const poly_coeff_t *dense, poly_exp_t n) {
+    poly_coeff_t *copy = malloc(n * sizeof(poly_coeff_t));
+    if (copy == NULL) exit(1);
+    memcpy(copy, dense, n * sizeof(poly_coeff_t));
+    return LeafFromDense(copy, 0, n);
+}
+
+/**
+ * Dzieli nieujemne współczynniki mniejsze od @ref SERIES_MODULUS_LIMIT na
+ * młodsze i starsze @ref SERIES_SPLIT_BITS bitów.
+ * @param[in] dense : tablica współczynników
+ * @param[in] n : liczba współczynników
+ * @param[out] parts : wielomiany z młodszych i starszych części
+ */
+static void SeriesSplit(const poly_coeff_t *dense, poly_exp_t n, Poly parts[2]) {
+    poly_coeff_t *low = malloc(n * sizeof(poly_coeff_t));
+    poly_coeff_t *high = malloc(n * sizeof(poly_coeff_t));
+    if (low == NULL || high == NULL) exit(1);
+    for (poly_exp_t i = 0; i < n; i++) {
+        low[i] = dense[i] & (((poly_coeff_t) 1 << SERIES_SPLIT_BITS) - 1);
+        high[i] = dense[i] >> SERIES_SPLIT_BITS;
+    }
+    parts[0] = LeafFromDense(low, 0, n);
+    parts[1] = LeafFromDense(high, 0, n);
+}
+
+/**
+ * Mnoży szeregi modulo @f$x^n@f$ za pomocą @ref PolyMulTrunc. Modulo
+ * @f$m > 0@f$ suma iloczynów współczynników mogłaby się przepełnić, więc
+ * dla dużych @f$m@f$ współczynniki są dzielone na starszą i młodszą część
+ * po @ref SERIES_SPLIT_BITS bitów, a iloczyny czterech par części są
+ * redukowane osobno.
+ * @param[in] a : współczynniki pierwszego szeregu
+ * @param[in] a_len : liczba współczynników @p a
+ * @param[in] b : współczynniki drugiego szeregu
+ * @param[in] b_len : liczba współczynników @p b
+ * @param[in] n : liczba współczynników iloczynu
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @return tablica @p n współczynników iloczynu zaalokowana na stercie
+ */
+static poly_coeff_t *SeriesMul(const poly_coeff_t *a, poly_exp_t a_len,
+                               const poly_coeff_t *b, poly_exp_t b_len,
+                               poly_exp_t n, poly_coeff_t m) {
+    poly_coeff_t *result;
+    if (m == 0 || (m - 1) * (m - 1) <= LONG_MAX / n) {
+        Poly a_poly = SeriesToPoly(a, a_len), b_poly = SeriesToPoly(b, b_len);
+        Poly product = PolyMulTrunc(&a_poly, &b_poly, n - 1);
+        result = SeriesToDense(&product, n);
+        PolyDestroy(&product);
+        for (poly_exp_t i = 0; i < n; i++)
+            result[i] = ModReduce(result[i], m);
+        PolyDestroy(&a_poly);
+        PolyDestroy(&b_poly);
+    }
+    else {
+        /* Części współczynników mają najwyżej 16 bitów, więc suma n < 2^31
+         * iloczynów części się nie przepełni */
+        poly_coeff_t low_mask = ((poly_coeff_t) 1 << SERIES_SPLIT_BITS) - 1;
+        Poly a_part[2], b_part[2];
+        SeriesSplit(a, a_len, a_part);
+        SeriesSplit(b, b_len, b_part);
+        poly_coeff_t shifts[3] = {1, ModReduce(low_mask + 1, m),
+                                  ModReduce((low_mask + 1) * (low_mask + 1), m)};
+        result = calloc(n, sizeof(poly_coeff_t));
+        if (result == NULL) exit(1);
+        for (int i = 0; i < 2; i++) {
+            for (int j = 0; j < 2; j++) {
+                Poly product = PolyMulTrunc(&a_part[i], &b_part[j], n - 1);
+                MonosView v;
+                MonosViewInit(&v, &product);
+                for (size_t k = 0; k < v.size; k++)
+                    result[v.exps[k]] = (result[v.exps[k]] +
+                                         ModReduce(v.values[k], m) * shifts[i + j]) % m;
+                PolyDestroy(&product);
+            }
+        }
+        for (int i = 0; i < 2; i++) {
+            PolyDestroy(&a_part[i]);
+            PolyDestroy(&b_part[i]);
+        }
+    }
+    return result;
+}
+
+/**
+ * Wylicza odwrotność szeregu modulo @f$x^n@f$ metodą Newtona
+ * @f$g \leftarrow g(2 - fg)@f$, podwajając w każdym kroku liczbę poprawnych
+ * współczynników. Łączny koszt to stała liczba mnożeń długości @p n.
+ * @param[in] f : współczynniki szeregu
+ * @param[in] n : liczba współczynników
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @param[in] f0_inv : odwrotność wyrazu wolnego @p f
+ * @return tablica @p n współczynników odwrotności zaalokowana na stercie
+ */
+static poly_coeff_t *SeriesInvNewton(const poly_coeff_t *f, poly_exp_t n, poly_coeff_t m,
+                                     poly_coeff_t f0_inv) {
+    poly_coeff_t *g = calloc(n, sizeof(poly_coeff_t));
+    if (g == NULL) exit(1);
+    g[0] = f0_inv;
+    for (poly_exp_t k = 1; k < n;) {
+        poly_exp_t next = k < n - k ? 2 * k : n;
+        poly_coeff_t *e = SeriesMul(f, next, g, k, next, m);
+        for (poly_exp_t i = 0; i < next; i++)
+            e[i] = ModReduce((i == 0 ? 2 : 0) - e[i], m);
+        poly_coeff_t *product = SeriesMul(g, k, e, next, next, m);
+        memcpy(g, product, next * sizeof(poly_coeff_t));
+        free(product);
+        free(e);
+        k = next;
+    }
+    return g;
+}
+
+/**
+ * Wylicza odwrotność szeregu, jeśli jego wyraz wolny jest odwracalny.
+ * @param[in] f : współczynniki szeregu
+ * @param[in] n : liczba współczynników
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @return tablica współczynników odwrotności lub NULL
+ */
+static poly_coeff_t *SeriesInv(const poly_coeff_t *f, poly_exp_t n, poly_coeff_t m) {
+    poly_coeff_t f0_inv;
+    if (!CoeffInverse(f[0], m, &f0_inv))
+        return NULL;
+    return SeriesInvNewton(f, n, m, f0_inv);
+}
+
+/**
+ * Wylicza pierwiastek szeregu o wyrazie wolnym 1. Modulo nieparzystego
+ * @f$m@f$ stosuje metodę Newtona @f$g \leftarrow (g + f/g) / 2@f$. Modulo
+ * @f$2^{64}@f$ nie można dzielić przez 2, więc dla @f$f = 1 + 4h@f$
+ * szuka pierwiastka postaci @f$1 + 2t@f$, czyli rozwiązuje metodą Newtona
+ * równanie @f$t^2 + t = h@f$, w którym pochodna @f$1 + 2t@f$ jest odwracalna.
+ * @param[in] f : współczynniki szeregu
+ * @param[in] n : liczba współczynników
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @return tablica współczynników pierwiastka lub NULL, jeśli wyraz wolny
+ * nie jest równy 1, @f$m@f$ jest parzyste lub modulo @f$2^{64}@f$ któryś
+ * z pozostałych współczynników nie jest podzielny przez 4
+ */
+static poly_coeff_t *SeriesSqrt(const poly_coeff_t *f, poly_exp_t n, poly_coeff_t m) {
+    if (f[0] != 1 || (m != 0 && m % 2 == 0))
+        return NULL;
+    for (poly_exp_t i = 1; i < n && m == 0; i++)
+        if (f[i] % 4 != 0)
+            return NULL;
+
+    poly_coeff_t *g = calloc(n, sizeof(poly_coeff_t));
+    if (g == NULL) exit(1);
+    g[0] = m == 0 ? 0 : 1;
+    for (poly_exp_t k = 1; k < n;) {
+        poly_exp_t next = k < n - k ? 2 * k : n;
+        if (m != 0) {
+            poly_coeff_t *g_inv = SeriesInvNewton(g, next, m, 1);
+            poly_coeff_t *quotient = SeriesMul(f, next, g_inv, next, next, m);
+            for (poly_exp_t i = 0; i < next; i++)
+                g[i] = (g[i] + quotient[i]) % m * ((m + 1) / 2) % m;
+            free(quotient);
+            free(g_inv);
+        }
+        else {
+            /* Tu g przechowuje t, a F(t) = t^2 + t - h */
+            poly_coeff_t *value = SeriesMul(g, k, g, k, next, m);
+            poly_coeff_t *derivative = malloc(next * sizeof(poly_coeff_t));
+            if (derivative == NULL) exit(1);
+            for (poly_exp_t i = 0; i < next; i++) {
+                value[i] += g[i] - (i == 0 ? 0 : f[i] / 4);
+                derivative[i] = (i == 0 ? 1 : 0) + 2 * g[i];
+            }
+            poly_coeff_t *derivative_inv = SeriesInvNewton(derivative, next, m, 1);
+            poly_coeff_t *step = SeriesMul(value, next, derivative_inv, next, next, m);
+            for (poly_exp_t i = 0; i < next; i++)
+                g[i] -= step[i];
+            free(step);
+            free(derivative_inv);
+            free(derivative);
+            free(value);
+        }
+        k = next;
+    }
+    if (m == 0)
+        for (poly_exp_t i = 0; i < n; i++)
+            g[i] = (i == 0 ? 1 : 0) + 2 * g[i];
+    return g;
+}
+
+/**
+ * Wylicza eksponentę szeregu o zerowym wyrazie wolnym metodą Newtona
+ * @f$g \leftarrow g(1 + f - \log g)@f$, gdzie @f$\log g@f$ jest całką
+ * z @f$g'/g@f$. Całkowanie wymaga odwrotności liczb @f$1, \ldots, n - 1@f$,
+ * więc eksponenta jest liczona tylko modulo @f$m > 0@f$, dla którego one
+ * istnieją. Modulo @f$2^{64}@f$ współczynniki eksponenty mają zwykle
+ * w mianownikach liczby parzyste.
+ * @param[in] f : współczynniki szeregu
+ * @param[in] n : liczba współczynników
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @return tablica współczynników eksponenty lub NULL
+ */
+static poly_coeff_t *SeriesExp(const poly_coeff_t *f, poly_exp_t n, poly_coeff_t m) {
+    if (m == 0 || f[0] != 0)
+        return NULL;
+    poly_coeff_t *inverses = malloc(n * sizeof(poly_coeff_t));
+    if (inverses == NULL) exit(1);
+    for (poly_exp_t i = 1; i < n; i++) {
+        if (!CoeffInverse(i, m, &inverses[i])) {
+            free(inverses);
+            return NULL;
+        }
+    }
+
+    poly_coeff_t *g = calloc(n, sizeof(poly_coeff_t));
+    if (g == NULL) exit(1);
+    g[0] = 1;
+    for (poly_exp_t k = 1; k < n;) {
+        poly_exp_t next = k < n - k ? 2 * k : n;
+        /* log g = całka z g' / g */
+        poly_coeff_t *derivative = malloc((next - 1) * sizeof(poly_coeff_t));
+        if (derivative == NULL) exit(1);
+        for (poly_exp_t i = 0; i < next - 1; i++)
+            derivative[i] = (i + 1) % m * g[i + 1] % m;
+        poly_coeff_t *g_inv = SeriesInvNewton(g, next - 1, m, 1);
+        poly_coeff_t *quotient = SeriesMul(derivative, next - 1, g_inv, next - 1, next - 1, m);
+        poly_coeff_t *e = malloc(next * sizeof(poly_coeff_t));
+        if (e == NULL) exit(1);
+        e[0] = 1;
+        for (poly_exp_t i = 1; i < next; i++)
+            e[i] = ModReduce(f[i] - quotient[i - 1] * inverses[i] % m, m);
+        poly_coeff_t *product = SeriesMul(g, k, e, next, next, m);
+        memcpy(g, product, next * sizeof(poly_coeff_t));
+        free(product);
+        free(e);
+        free(quotient);
+        free(g_inv);
+        free(derivative);
+        k = next;
+    }
+    free(inverses);
+    return g;
+}
+
+/**
+ * Wykonuje działanie na szeregu potęgowym zmiennej @f$x_0@f$.
+ * @param[in] p : wielomian
+ * @param[in] n : liczba współczynników wyniku
+ * @param[in] m : moduł lub 0 dla liczb modulo @f$2^{64}@f$
+ * @param[out] result : wynik
+ * @param[in] op : działanie na tablicy współczynników zwracające NULL, gdy
+ * wynik nie istnieje
+ * @return Czy wynik istnieje?
+ */
+static bool SeriesOperation(const Poly *p, poly_exp_t n, poly_coeff_t m, Poly *result,
+                            poly_coeff_t *(*op)(const poly_coeff_t *, poly_exp_t,
+                                                poly_coeff_t)) {
+    assert(n >= 0 && (m == 0 || (m >= 2 && m < SERIES_MODULUS_LIMIT)));
+    if (!PolyIsCoeff(p) && !PolyIsFlat(p))
+        return false;
+    /* Warunki istnienia wyniku zależą od wyrazu wolnego, więc sprawdza je
+     * także dla n = 0 */
+    poly_exp_t size = n == 0 ? 1 : n;
+    poly_coeff_t *f = SeriesToDense(p, size);
+    for (poly_exp_t i = 0; i < size; i++)
+        f[i] = ModReduce(f[i], m);
+    poly_coeff_t *g = op(f, size, m);
+    free(f);
+    if (g == NULL)
+        return false;
+    *result = n == 0 ? PolyZero() : SeriesToPoly(g, n);
+    free(g);
+    return true;
+}
+
+bool PolySeriesInv(const Poly *p, poly_exp_t n, poly_coeff_t m, Poly *result) {
+    return SeriesOperation(p, n, m, result, SeriesInv);
+}
+
+bool PolySeriesSqrt(const Poly *p, poly_exp_t n, poly_coeff_t m, Poly *result) {
+    return SeriesOperation(p, n, m, result, SeriesSqrt);
+}
+
+bool PolySeriesExp(const Poly *p, poly_exp_t n, poly_coeff_t m, Poly *result) {
+    return SeriesOperation(p, n, m, result, SeriesExp);
+}
+
+/**
+ * Strumień jednomianów iloczynu jednomianu ilorazu przez kolejne, coraz
+ * niższe jednomiany dzielnika (bez jednomianu wiodącego) w dzieleniu
+ * @ref DivHelper.
+ */
+typedef struct {
+    poly_exp_t exp; ///< wykładnik bieżącego jednomianu strumienia
+    size_t term; ///< indeks jednomianu ilorazu
+    size_t tail; ///< indeks bieżącego jednomianu dzielnika
+} DivStream;
+
+/**
+ * Przywraca własność kopca (o największym wykładniku w korzeniu), przesuwając
+ * strumień z pozycji @p i w dół.
+ * @param[in,out] heap : kopiec strumieni
+ * @param[in] size : rozmiar kopca
+ * @param[in] i : pozycja przesuwanego strumienia
+ */
+static void DivHeapDown(DivStream *heap, size_t size, size_t i) {
+    DivStream moved = heap[i];
+    while (2 * i + 1 < size) {
+        size_t child = 2 * i + 1;
+        if (child + 1 < size && heap[child + 1].exp > heap[child].exp)
+            child++;
+        if (heap[child].exp <= moved.exp)
+            break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = moved;
+}
+
+/**
+ * Przywraca własność kopca (o największym wykładniku w korzeniu), przesuwając
+ * strumień z pozycji @p i w górę.
+ * @param[in,out] heap : kopiec strumieni
+ * @param[in] i : pozycja przesuwanego strumienia
+ */
+static void DivHeapUp(DivStream *heap, size_t i) {
+    DivStream moved = heap[i];
+    while (i > 0 && heap[(i - 1) / 2].exp < moved.exp) {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = moved;
+}
+
+/**
+ * Odwraca kolejność jednomianów w tablicy.
+ * @param[in,out] monos : tablica jednomianów
+ * @param[in] size : liczba jednomianów
+ */
+static void ReverseMonos(Mono *monos, size_t size) {
+    for (size_t i = 0; i < size / 2; i++) {
+        Mono temp = monos[i];
+        monos[i] = monos[size - 1 - i];
+        monos[size - 1 - i] = temp;
+    }
+}
+
+/**
+ * Dzieli wielomian przez wielomian unormowany względem zmiennej głównej,
+ * wyznaczając jednomiany ilorazu i reszty od najwyższego wykładnika.
+ * Kopiec przechowuje dla każdego jednomianu ilorazu strumień jego iloczynów
+ * z kolejnymi jednomianami dzielnika, więc bieżący jednomian @f$p - qd@f$
+ * powstaje z jednomianu @p p i iloczynów o tym samym wykładniku zdjętych
+ * z kopca, bez odejmowania całych wielomianów. Dzięki temu dzielenie
+ * kosztuje @f$O(n \log |q|)@f$ operacji na współczynnikach dla @f$n@f$
+ * iloczynów jednomianów @f$q@f$ i @f$d@f$.
+ * @param[in] p : dzielna
+ * @param[in] d : dzielnik
+ * @param[out] q : iloraz
+ * @param[out] r : reszta lub NULL, jeśli dzielenie ma być dokładne; wtedy
+ * dzielenie kończy się na pierwszym niezerowym jednomianie reszty
+ * @return Czy dzielnik jest unormowany i, przy dzieleniu dokładnym, dzieli
+ * @p p?
+ */
+static bool DivHelper(const Poly *p, const Poly *d, Poly *q, Poly *r) {
+    MonosView p_view, d_view;
+    MonosViewInit(&p_view, p);
+    MonosViewInit(&d_view, d);
+    if (d_view.size == 0)
+        return false;
+    size_t tail = d_view.size - 1;
+    Poly lead = MonosViewCoeff(&d_view, tail);
+    if (!PolyIsCoeff(&lead) || lead.coeff != 1)
+        return false;
+    poly_exp_t k = d_view.exps[tail];
+
+    Poly *neg_tail = malloc((tail == 0 ? 1 : tail) * sizeof(Poly));
+    if (neg_tail == NULL) exit(1);
+    for (size_t j = 0; j < tail; j++) {
+        Poly coeff = MonosViewCoeff(&d_view, j);
+        neg_tail[j] = PolyNeg(&coeff);
+    }
+
+    size_t capacity = 4, r_capacity = 4;
+    Mono *quotient = SafeMonoMalloc(capacity), *remainder = SafeMonoMalloc(r_capacity);
+    DivStream *heap = malloc(capacity * sizeof(DivStream));
+    /* Współczynniki czynników iloczynów o wspólnym wykładniku */
+    Poly *x_group = malloc(capacity * sizeof(Poly)), *y_group = malloc(capacity * sizeof(Poly));
+    if (heap == NULL || x_group == NULL || y_group == NULL) exit(1);
+    size_t q_size = 0, r_size = 0, heap_size = 0, next = p_view.size;
+    bool exact = true;
+    while ((next != 0 || heap_size != 0) && exact) {
+        poly_exp_t exp = heap_size == 0 ? p_view.exps[next - 1] :
+                         next == 0 ? heap[0].exp : MaxExp(heap[0].exp, p_view.exps[next - 1]);
+        poly_coeff_t constant = 0;
+        size_t group_size = 0;
+        bool flat = true;
+        while (heap_size != 0 && heap[0].exp == exp) {
+            DivStream *top = &heap[0];
+            x_group[group_size] = quotient[top->term].p;
+            y_group[group_size] = neg_tail[top->tail];
+            if (PolyIsCoeff(&x_group[group_size]) && PolyIsCoeff(&y_group[group_size]))
+                constant += x_group[group_size].coeff * y_group[group_size].coeff;
+            else
+                flat = false;
+            group_size++;
+
+            if (top->tail-- != 0)
+                top->exp = quotient[top->term].exp + d_view.exps[top->tail];
+            else
+                *top = heap[--heap_size];
+            DivHeapDown(heap, heap_size, 0);
+        }
+
+        Poly coeff = flat ? PolyFromCoeff(constant)
+                          : PolyDotProduct(group_size, x_group, y_group);
+        if (next != 0 && p_view.exps[next - 1] == exp) {
+            Poly p_coeff = MonosViewCoeff(&p_view, --next);
+            Poly sum = PolyAdd(&coeff, &p_coeff);
+            PolyDestroy(&coeff);
+            coeff = sum;
+        }
+        if (PolyIsZero(&coeff))
+            continue;
+
+        if (exp >= k) {
+            if (q_size == capacity) {
+                capacity *= 2;
+                quotient = realloc(quotient, capacity * sizeof(Mono));
+                heap = realloc(heap, capacity * sizeof(DivStream));
+                x_group = realloc(x_group, capacity * sizeof(Poly));
+                y_group = realloc(y_group, capacity * sizeof(Poly));
+                if (quotient == NULL || heap == NULL || x_group == NULL || y_group == NULL)
+                    exit(1);
+            }
+            /* Dzielnik jest unormowany, więc współczynnik ilorazu jest równy
+             * współczynnikowi bieżącego jednomianu */
+            quotient[q_size] = (Mono) {.p = coeff, .exp = exp - k};
+            if (tail != 0) {
+                heap[heap_size] = (DivStream) {
+                    .exp = exp - k + d_view.exps[tail - 1], .term = q_size, .tail = tail - 1};
+                DivHeapUp(heap, heap_size++);
+            }
+            q_size++;
+        }
+        else if (r == NULL) {
+            PolyDestroy(&coeff);
+            exact = false;
+        }
+        else {
+            if (r_size == r_capacity) {
+                r_capacity *= 2;
+                remainder = realloc(remainder, r_capacity * sizeof(Mono));
+                if (remainder == NULL) exit(1);
+            }
+            remainder[r_size++] = (Mono) {.p = coeff, .exp = exp};
+        }
+    }
+
+    for (size_t j = 0; j < tail; j++)
+        PolyDestroy(&neg_tail[j]);
+    free(neg_tail);
+    free(heap);
+    free(x_group);
+    free(y_group);
+    if (!exact) {
+        for (size_t i = 0; i < q_size; i++)
+            MonoDestroy(&quotient[i]);
+        free(quotient);
+        free(remainder);
+        return false;
+    }
+
+    ReverseMonos(quotient, q_size);
+    *q = PolyOwnMonos(q_size, quotient);
+    if (r != NULL) {
+        ReverseMonos(remainder, r_size);
+        *r = PolyOwnMonos(r_size, remainder);
+    }
+    else
+        free(remainder);
+    return true;
+}
+
+bool PolyDivRem(const Poly *p, const Poly *d, Poly *q, Poly *r) {
+    return DivHelper(p, d, q, r);
+}
+
+bool PolyDivExact(const Poly *p, const Poly *d, Poly *q) {
+    return DivHelper(p, d, q, NULL);
+}
+
+/**
+ * Sortuje stabilnie indeksy składników względem wykładnika jednej zmiennej,
+ * cyfra po cyfrze od najmłodszej (sortowanie pozycyjne LSD). Wykładniki są
+ * najpierw zbierane w kolejności indeksów, więc kolejne przebiegi czytają
+ * pamięć sekwencyjnie. Pomija cyfry, które są zerowe we wszystkich
+ * wykładnikach.
+ * @param[in] exps : wykładniki składników, po @p vars na składnik
+ * @param[in] vars : liczba zmiennych
+ * @param[in] var : indeks zmiennej, względem której sortuje
+ * @param[in] count : liczba składników
+ * @param[in,out] order : indeksy składników
+ * @param[in,out] temp : tablica pomocnicza na @p count indeksów
+ * @param[in,out] keys : tablica pomocnicza na @p 2 * count wykładników
+ */
+static void RadixSortTermsByVar(const poly_exp_t *exps, size_t vars, size_t var,
+                                size_t count, size_t *order, size_t *temp,
+                                unsigned *keys) {
+    unsigned *temp_keys = keys + count;
+    unsigned max_exp = 0;
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = (unsigned) exps[order[i] * vars + var];
+        max_exp |= keys[i];
+    }
+
+    for (unsigned shift = 0; shift < 32 && (max_exp >> shift) != 0; shift += RADIX_BITS) {
+        size_t offsets[RADIX_SIZE] = {0};
+        for (size_t i = 0; i < count; i++)
+            offsets[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+        size_t sum = 0;
+        for (size_t d = 0; d < RADIX_SIZE; d++) {
+            size_t digit_count = offsets[d];
+            offsets[d] = sum;
+            sum += digit_count;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t j = offsets[(keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+            temp[j] = order[i];
+            temp_keys[j] = keys[i];
+        }
+        memcpy(order, temp, count * sizeof(size_t));
+        memcpy(keys, temp_keys, count * sizeof(unsigned));
+    }
+}
+
+/**
+ * Porównuje leksykograficznie wektory wykładników dwóch składników.
+ * @param[in] a : wykładniki pierwszego składnika
+ * @param[in] b : wykładniki drugiego składnika
+ * @param[in] vars : liczba zmiennych
+ * @return liczba ujemna, zero lub dodatnia, gdy pierwszy wektor jest
+ * odpowiednio mniejszy, równy lub większy od drugiego
+ */
+static int CompareTermExps(const poly_exp_t *a, const poly_exp_t *b, size_t vars) {
+    for (size_t var = 0; var < vars; var++)
+        if (a[var] != b[var])
+            return a[var] < b[var] ? -1 : 1;
+    return 0;
+}
+
+/**
+ * Sortuje składniki leksykograficznie względem wektorów wykładników (najpierw
+ * względem @f$x_0@f$). Tablice już posortowane są rozpoznawane w czasie
+ * liniowym, a pozostałe sortowane pozycyjnie względem kolejnych zmiennych,
+ * od ostatniej.
+ * @param[in] vars : liczba zmiennych
+ * @param[in] count : liczba składników
+ * @param[in,out] exps : wykładniki składników, po @p vars na składnik
+ * @param[in,out] coeffs : współczynniki składników
+ */
+static void SortTerms(size_t vars, size_t count, poly_exp_t *exps, poly_coeff_t *coeffs) {
+    size_t i = 1;
+    while (i < count && CompareTermExps(exps + (i - 1) * vars, exps + i * vars, vars) <= 0)
+        i++;
+    if (i >= count)
+        return;
+
+    size_t *order = malloc(2 * count * sizeof(size_t));
+    unsigned *keys = malloc(2 * count * sizeof(unsigned));
+    poly_exp_t *sorted_exps = malloc(vars * count * sizeof(poly_exp_t));
+    poly_coeff_t *sorted_coeffs = malloc(count * sizeof(poly_coeff_t));
+    if (order == NULL || keys == NULL || sorted_exps == NULL || sorted_coeffs == NULL)
+        exit(1);
+    for (i = 0; i < count; i++)
+        order[i] = i;
+    /* Sortowanie LSD: ostatnia zmienna jest najmniej znacząca */
+    for (size_t var = vars; var-- > 0;)
+        RadixSortTermsByVar(exps, vars, var, count, order, order + count, keys);
+    for (i = 0; i < count; i++) {
+        memcpy(sorted_exps + i * vars, exps + order[i] * vars, vars * sizeof(poly_exp_t));
+        sorted_coeffs[i] = coeffs[order[i]];
+    }
+    memcpy(exps, sorted_exps, vars * count * sizeof(poly_exp_t));
+    memcpy(coeffs, sorted_coeffs, count * sizeof(poly_coeff_t));
+    free(order);
+    free(keys);
+    free(sorted_exps);
+    free(sorted_coeffs);
+}
+
+/**
+ * Sortuje składniki leksykograficznie, a następnie sumuje składniki o równych
+ * wektorach wykładników i usuwa składniki o zerowych współczynnikach.
+ * @param[in] vars : liczba zmiennych
+ * @param[in] count : liczba składników
+ * @param[in,out] exps : wykładniki składników, po @p vars na składnik
+ * @param[in,out] coeffs : współczynniki składników
+ * @return liczba składników po uproszczeniu; zajmują one początki tablic
+ */
+static size_t SimplifyTerms(size_t vars, size_t count, poly_exp_t *exps,
+                            poly_coeff_t *coeffs) {
+    SortTerms(vars, count, exps, coeffs);
+    size_t size = 0;
+    for (size_t i = 0; i < count; i++) {
+        const poly_exp_t *term = exps + i * vars;
+        if (size != 0 && CompareTermExps(exps + (size - 1) * vars, term, vars) == 0) {
+            coeffs[size - 1] += coeffs[i];
+            /* Jeśli składniki się zredukowały, ich miejsce zajmie następny */
+            if (coeffs[size - 1] == 0)
+                size--;
+        }
+        else if (coeffs[i] != 0) {
+            if (size != i) {
+                memmove(exps + size * vars, term, vars * sizeof(poly_exp_t));
+                coeffs[size] = coeffs[i];
+            }
+            size++;
+        }
+    }
+    return size;
+}
+
+/**
+ * Tworzy wielomian ze składników o indeksach od @p from do @p to - 1,
+ * posortowanych leksykograficznie, o parami różnych wektorach wykładników
+ * i niezerowych współczynnikach, grupując je rekurencyjnie względem kolejnych
+ * zmiennych. Węzły są tworzone od razu w docelowym rozmiarze.
+ * @param[in] vars : liczba zmiennych
+ * @param[in] exps : wykładniki składników, po @p vars na składnik
+ * @param[in] coeffs : współczynniki składników
+ * @param[in] from : indeks pierwszego składnika
+ * @param[in] to : indeks za ostatnim składnikiem
+ * @param[in] var : indeks zmiennej, względem której są grupowane składniki
+ * @return wielomian zmiennych @f$x_{var}, x_{var + 1}, \ldots@f$
+ */
+static Poly TermsToPoly(size_t vars, const poly_exp_t *exps, const poly_coeff_t *coeffs,
+                        size_t from, size_t to, size_t var) {
+    if (from == to)
         return PolyZero();
-    if (PolyIsCoeff(p))
-        return PolyFromCoeff(p->coeff);
+    /* Wszystkie zmienne zostały ustalone, więc został jeden składnik */
+    if (var == vars)
+        return PolyFromCoeff(coeffs[from]);
 
-    /* Wielomian, do którego są dodawane kolejne współczynniki po pomnożeniu przez x */
-    Poly result = PolyZero();
+    if (var == vars - 1) {
+        size_t size = to - from;
+        PolyNode *node = LeafMalloc(size);
+        poly_coeff_t *values = LeafCoeffs(node, size);
+        for (size_t i = 0; i < size; i++) {
+            node->exps[i] = exps[(from + i) * vars + var];
+            values[i] = coeffs[from + i];
+        }
+        return PolyFromLeaf(node, size, size);
+    }
 
-    for (size_t i = 0; i < p->size; i++) {
-        poly_coeff_t coeff = QuickPow(x, p->arr[i].exp);
-        Poly multiplied_poly = PolyMulByCoeff(&p->arr[i].p, coeff);
+    size_t groups = 1;
+    for (size_t i = from + 1; i < to; i++)
+        groups += exps[i * vars + var] != exps[(i - 1) * vars + var];
+    PolyNode *node = NodeMalloc(groups);
+    Poly *children = NodeCoeffs(node, groups);
+    size_t index = 0, start = from;
+    for (size_t i = from + 1; i <= to; i++) {
+        if (i == to || exps[i * vars + var] != exps[start * vars + var]) {
+            node->exps[index] = exps[start * vars + var];
+            children[index++] = TermsToPoly(vars, exps, coeffs, start, i, var + 1);
+            start = i;
+        }
+    }
+    return PolyFromNode(node, groups, groups);
+}
 
-        Poly prev_result = result;
-        result = PolyAdd(&result, &multiplied_poly);
-        PolyDestroy(&prev_result);
-        PolyDestroy(&multiplied_poly);
+/** Początkowa pojemność bufora @ref PolyBuilder. */
+#define BUILDER_INITIAL_CAPACITY 1024
+
+/**
+ * To jest struktura budująca wielomian ze składników dodawanych po jednym.
+ * Składniki trafiają do bufora, który po zapełnieniu jest sortowany
+ * i upraszczany. Bufor jest powiększany dopiero wtedy, gdy po uproszczeniu
+ * jest zapełniony w ponad połowie, więc zajmuje pamięć proporcjonalną do
+ * liczby różnych składników, a nie wszystkich dodanych.
+ */
+struct PolyBuilder {
+    size_t vars; ///< liczba zmiennych
+    size_t size; ///< liczba składników w buforze
+    size_t capacity; ///< pojemność bufora
+    poly_exp_t *exps; ///< wykładniki składników, po @p vars na składnik
+    poly_coeff_t *coeffs; ///< współczynniki składników
+};
+
+PolyBuilder *PolyBuilderNew(size_t vars) {
+    PolyBuilder *b = malloc(sizeof(PolyBuilder));
+    if (b == NULL) exit(1);
+    b->vars = vars;
+    b->size = 0;
+    b->capacity = BUILDER_INITIAL_CAPACITY;
+    b->exps = malloc((vars == 0 ? 1 : vars * b->capacity) * sizeof(poly_exp_t));
+    b->coeffs = malloc(b->capacity * sizeof(poly_coeff_t));
+    if (b->exps == NULL || b->coeffs == NULL) exit(1);
+    return b;
+}
+
+void PolyBuilderAdd(PolyBuilder *b, const poly_exp_t exps[], poly_coeff_t c) {
+    if (c == 0)
+        return;
+    if (b->size == b->capacity) {
+        b->size = SimplifyTerms(b->vars, b->size, b->exps, b->coeffs);
+        if (2 * b->size > b->capacity) {
+            b->capacity *= 2;
+            b->coeffs = realloc(b->coeffs, b->capacity * sizeof(poly_coeff_t));
+            if (b->vars != 0)
+                b->exps = realloc(b->exps, b->vars * b->capacity * sizeof(poly_exp_t));
+            if (b->exps == NULL || b->coeffs == NULL) exit(1);
+        }
     }
+    for (size_t var = 0; var < b->vars; var++)
+        assert(exps[var] >= 0);
+    if (b->vars != 0)
+        memcpy(b->exps + b->size * b->vars, exps, b->vars * sizeof(poly_exp_t));
+    b->coeffs[b->size++] = c;
+}
+
+Poly PolyBuilderFinish(PolyBuilder *b) {
+    size_t size = SimplifyTerms(b->vars, b->size, b->exps, b->coeffs);
+    Poly result = TermsToPoly(b->vars, b->exps, b->coeffs, 0, size, 0);
+    free(b->exps);
+    free(b->coeffs);
+    free(b);
     return result;
 }
 
 /**
- * Wykonuje szybkie potęgowanie wielomianu do potęgi @p exp.
+ * Sprawdza, czy składniki są posortowane leksykograficznie, mają parami różne
+ * wektory wykładników i niezerowe współczynniki.
+ * @param[in] vars : liczba zmiennych
+ * @param[in] count : liczba składników
+ * @param[in] exps : wykładniki składników, po @p vars na składnik
+ * @param[in] coeffs : współczynniki składników
+ * @return Czy składniki są w postaci kanonicznej?
+ */
+static bool TermsAreCanonical(size_t vars, size_t count, const poly_exp_t *exps,
+                              const poly_coeff_t *coeffs) {
+    for (size_t i = 0; i < count; i++) {
+        if (coeffs[i] == 0)
+            return false;
+        if (i > 0 && CompareTermExps(exps + (i - 1) * vars, exps + i * vars, vars) >= 0)
+            return false;
+    }
+    return true;
+}
+
+Poly PolyFromTerms(size_t vars, size_t count, const poly_exp_t exps[],
+                   const poly_coeff_t coeffs[]) {
+    for (size_t i = 0; i < vars * count; i++)
+        assert(exps[i] >= 0);
+    /* Składniki w postaci kanonicznej nie wymagają kopii */
+    if (TermsAreCanonical(vars, count, exps, coeffs))
+        return TermsToPoly(vars, exps, coeffs, 0, count, 0);
+
+    poly_exp_t *own_exps = malloc((vars == 0 ? 1 : vars * count) * sizeof(poly_exp_t));
+    poly_coeff_t *own_coeffs = malloc(count * sizeof(poly_coeff_t));
+    if (own_exps == NULL || own_coeffs == NULL) exit(1);
+    if (vars != 0)
+        memcpy(own_exps, exps, vars * count * sizeof(poly_exp_t));
+    memcpy(own_coeffs, coeffs, count * sizeof(poly_coeff_t));
+    size_t size = SimplifyTerms(vars, count, own_exps, own_coeffs);
+    Poly result = TermsToPoly(vars, own_exps, own_coeffs, 0, size, 0);
+    free(own_exps);
+    free(own_coeffs);
+    return result;
+}
+
+/**
+ * Sprawdza, czy wykładniki o indeksach od @p from do @p to - 1 są zerowe.
+ * @param[in] exps : wykładniki
+ * @param[in] from : pierwszy sprawdzany indeks
+ * @param[in] to : indeks za ostatnim sprawdzanym
+ * @return Czy wszystkie sprawdzane wykładniki są zerowe?
+ */
+static bool ExpsAreZero(const poly_exp_t *exps, size_t from, size_t to) {
+    for (size_t i = from; i < to; i++)
+        if (exps[i] != 0)
+            return false;
+    return true;
+}
+
+poly_coeff_t PolyCoeffOf(const Poly *p, size_t k, const poly_exp_t exps[]) {
+    size_t var = 0;
+    /* Po wyczerpaniu podanych wykładników szukany jest wyraz z x^0 */
+    while (!PolyIsCoeff(p)) {
+        poly_exp_t exp = var < k ? exps[var] : 0;
+        MonosView v;
+        MonosViewInit(&v, p);
+        size_t i = GallopExps(v.exps, 0, v.size, exp);
+        if (i == v.size || v.exps[i] != exp)
+            return 0;
+        var++;
+        if (v.values != NULL)
+            return ExpsAreZero(exps, var, k) ? v.values[i] : 0;
+        p = &v.coeffs[i];
+    }
+    return ExpsAreZero(exps, var, k) ? p->coeff : 0;
+}
+
+size_t PolyTermCount(const Poly *p) {
+    if (PolyIsCoeff(p))
+        return PolyIsZero(p) ? 0 : 1;
+    if (!PolyIsInner(p))
+        return PolyIsInline(p) ? 1 : p->size;
+
+    size_t count = 0;
+    WalkStack stack;
+    WalkStackInit(&stack);
+    WalkStackPush(&stack, p, NULL);
+    while (stack.size != 0) {
+        WalkFrame *top = &stack.frames[stack.size - 1];
+        if (top->index == top->size) {
+            stack.size--;
+            continue;
+        }
+        const Poly *coeff = &top->coeffs[top->index++];
+        if (PolyIsInner(coeff))
+            WalkStackPush(&stack, coeff, NULL);
+        else if (PolyIsCoeff(coeff))
+            count += !PolyIsZero(coeff);
+        else
+            count += PolyIsInline(coeff) ? 1 : coeff->size;
+    }
+    WalkStackFree(&stack);
+    return count;
+}
+
+/**
+ * Zapisuje do wiersza @p row tablic składniki wielomianu, który nie jest
+ * przechowywany w węźle wewnętrznym, jako wielomianu zmiennych
+ * @f$x_{var}, x_{var + 1}, \ldots@f$. Wykładniki zmiennych o indeksach
+ * mniejszych od @p var uzupełnia wywołujący.
  * @param[in] p : wielomian
- * @param[in] exp : wykładnik potęgi
- * @return wielomian będący wynikiem potęgowania
+ * @param[in] vars : liczba zmiennych
+ * @param[in] var : indeks zmiennej
+ * @param[out] exps : wykładniki składników, po @p vars na składnik
+ * @param[out] coeffs : współczynniki składników
+ * @param[in] row : indeks pierwszego wolnego wiersza
+ * @return liczba zapisanych składników
  */
-static Poly QuickPolyPow(const Poly *p, poly_coeff_t exp) {
-    if (exp == 0)
-        return PolyFromCoeff(1);
-    if (exp % 2 == 1){
-        Poly res = QuickPolyPow(p, exp - 1);
-        Poly mul_res = PolyMul(p, &res);
-        PolyDestroy(&res);
-        return mul_res;
+static size_t FlattenFlat(const Poly *p, size_t vars, size_t var, poly_exp_t *exps,
+                          poly_coeff_t *coeffs, size_t row) {
+    if (PolyIsCoeff(p)) {
+        if (PolyIsZero(p))
+            return 0;
+        for (size_t i = var; i < vars; i++)
+            exps[row * vars + i] = 0;
+        coeffs[row] = p->coeff;
+        return 1;
     }
 
-    Poly result = QuickPolyPow(p, exp / 2);
-    Poly mul_res = PolyMul(&result, &result);
-    PolyDestroy(&result);
-    return mul_res;
+    assert(var < vars);
+    MonosView v;
+    MonosViewInit(&v, p);
+    for (size_t i = 0; i < v.size; i++) {
+        exps[(row + i) * vars + var] = v.exps[i];
+        for (size_t j = var + 1; j < vars; j++)
+            exps[(row + i) * vars + j] = 0;
+        coeffs[row + i] = v.values[i];
+    }
+    return v.size;
 }
 
 /**
- * Dokonuje rekurencyjnego składania wielomianów.
- * @param p : wielomian
- * @param poly_index : indeks wielomianu z tablicy @p q, od którego rozpoczynamy składanie
- * @param size : rozmiar tablicy @p q
- * @param q : tablica wielomianów
- * @return
+ * Zapisuje składniki wielomianu do wierszy tablic w porządku
+ * leksykograficznym. Ramki stosu odpowiadają zmiennym @f$x_0, x_1, \ldots@f$,
+ * więc wykładniki początkowych zmiennych składnika odczytuje się z jednomianów
+ * przeglądanych przez kolejne ramki.
+ * @param[in] p : wielomian
+ * @param[in] vars : liczba zmiennych
+ * @param[out] exps : wykładniki składników, po @p vars na składnik
+ * @param[out] coeffs : współczynniki składników
+ * @return liczba zapisanych składników
  */
-Poly ComposeHelper(const Poly *p, long poly_index, const size_t size, const Poly q[]) {
+static size_t FlattenPoly(const Poly *p, size_t vars, poly_exp_t *exps,
+                          poly_coeff_t *coeffs) {
+    if (!PolyIsInner(p))
+        return FlattenFlat(p, vars, 0, exps, coeffs, 0);
+
+    size_t written = 0;
+    WalkStack stack;
+    WalkStackInit(&stack);
+    WalkStackPush(&stack, p, NULL);
+    while (stack.size != 0) {
+        WalkFrame *top = &stack.frames[stack.size - 1];
+        if (top->index == top->size) {
+            stack.size--;
+            continue;
+        }
+        const Poly *coeff = &top->coeffs[top->index++];
+        assert(stack.size < vars || (stack.size == vars && PolyIsCoeff(coeff)));
+        if (PolyIsInner(coeff)) {
+            WalkStackPush(&stack, coeff, NULL);
+            continue;
+        }
+
+        size_t count = FlattenFlat(coeff, vars, stack.size, exps, coeffs, written);
+        for (size_t level = 0; level < stack.size; level++) {
+            const WalkFrame *frame = &stack.frames[level];
+            poly_exp_t exp = frame->node->exps[frame->index - 1];
+            for (size_t r = written; r < written + count; r++)
+                exps[r * vars + level] = exp;
+        }
+        written += count;
+    }
+    WalkStackFree(&stack);
+    return written;
+}
+
+size_t PolyToTerms(const Poly *p, size_t vars, poly_exp_t exps[], poly_coeff_t coeffs[]) {
+    return FlattenPoly(p, vars, exps, coeffs);
+}
+
+size_t PolyDepth(const Poly *p) {
     if (PolyIsCoeff(p))
+        return 0;
+    if (!PolyIsInner(p))
+        return 1;
+
+    /* Współczynnik bez zagnieżdżonych węzłów leży na głębokości równej
+     * liczbie ramek nad nim, a liść lub jednomian dodaje jeszcze jedną
+     * zmienną */
+    size_t depth = 1;
+    WalkStack stack;
+    WalkStackInit(&stack);
+    WalkStackPush(&stack, p, NULL);
+    while (stack.size != 0) {
+        WalkFrame *top = &stack.frames[stack.size - 1];
+        if (top->index == top->size) {
+            stack.size--;
+            continue;
+        }
+        const Poly *coeff = &top->coeffs[top->index++];
+        if (PolyIsInner(coeff))
+            WalkStackPush(&stack, coeff, NULL);
+        else if (!PolyIsCoeff(coeff) && stack.size + 1 > depth)
+            depth = stack.size + 1;
+    }
+    WalkStackFree(&stack);
+    return depth;
+}
+
+void PolyTermIterInit(PolyTermIter *it, const Poly *p, PolyTermFrame frames[],
+                      poly_exp_t exps[], size_t capacity) {
+    it->frames = frames;
+    it->exps = exps;
+    it->capacity = capacity;
+    it->depth = 0;
+    it->shared = 0;
+    it->next_shared = 0;
+    it->coeff = 0;
+    it->root = p;
+    it->has_next = !PolyIsZero(p);
+    it->started = false;
+}
+
+/**
+ * Schodzi od jednomianu bieżącego na poziomie @p level do pierwszego
+ * składnika pod nim i ustala, z iloma początkowymi poziomami dzieli on
+ * ścieżkę ze składnikiem następnym.
+ * @param[in,out] it : iterator
+ * @param[in] level : poziom, od którego iterator schodzi
+ */
+static void TermIterDescend(PolyTermIter *it, size_t level) {
+    MonosView v;
+    while (true) {
+        PolyTermFrame *frame = &it->frames[level];
+        MonosViewInit(&v, frame->p);
+        it->exps[level] = v.exps[frame->index];
+        if (v.values != NULL) {
+            it->coeff = v.values[frame->index];
+            break;
+        }
+        const Poly *child = &v.coeffs[frame->index];
+        if (PolyIsCoeff(child)) {
+            it->coeff = child->coeff;
+            break;
+        }
+        level++;
+        assert(level < it->capacity);
+        it->frames[level] = (PolyTermFrame) {.p = child, .index = 0};
+    }
+    it->depth = level + 1;
+
+    /* Następny składnik zaczyna się od pierwszego poziomu, który nie jest
+     * na ostatnim jednomianie */
+    size_t next = it->depth;
+    while (next > 0) {
+        MonosViewInit(&v, it->frames[next - 1].p);
+        if (it->frames[next - 1].index + 1 < v.size)
+            break;
+        next--;
+    }
+    it->has_next = next > 0;
+    it->next_shared = next > 0 ? next - 1 : 0;
+}
+
+bool PolyTermIterNext(PolyTermIter *it) {
+    if (!it->has_next)
+        return false;
+    if (!it->started) {
+        it->started = true;
+        it->shared = 0;
+        if (PolyIsCoeff(it->root)) {
+            it->depth = 0;
+            it->coeff = it->root->coeff;
+            it->has_next = false;
+            return true;
+        }
+        assert(it->capacity > 0);
+        it->frames[0] = (PolyTermFrame) {.p = it->root, .index = 0};
+        TermIterDescend(it, 0);
+        return true;
+    }
+
+    it->shared = it->next_shared;
+    it->frames[it->shared].index++;
+    TermIterDescend(it, it->shared);
+    return true;
+}
+
+Poly PolyPermuteVars(const Poly *p, size_t k, const size_t perm[]) {
+    size_t fixed = 0;
+    while (fixed < k && perm[fixed] == fixed)
+        fixed++;
+    size_t count = PolyTermCount(p);
+    if (fixed == k || count == 0)
         return PolyClone(p);
 
-    poly_index++;
-    if (poly_index >= (long) size) {
-        for (size_t i = 0; i < p->size; i++) {
-            if (p->arr[i].exp == 0) {
-                return ComposeHelper(&p->arr[i].p, ++poly_index, size, q);
+    poly_exp_t *exps = malloc(2 * k * count * sizeof(poly_exp_t));
+    poly_coeff_t *coeffs = malloc(count * sizeof(poly_coeff_t));
+    if (exps == NULL || coeffs == NULL) exit(1);
+    poly_exp_t *permuted = exps + k * count;
+    PolyToTerms(p, k, exps, coeffs);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t var = 0; var < k; var++) {
+            assert(perm[var] < k);
+            permuted[i * k + perm[var]] = exps[i * k + var];
+        }
+    }
+    /* Permutacja zachowuje różnowartościowość wektorów wykładników, więc
+     * wystarczy je posortować */
+    SortTerms(k, count, permuted, coeffs);
+    Poly result = TermsToPoly(k, permuted, coeffs, 0, count, 0);
+    free(exps);
+    free(coeffs);
+    return result;
+}
+
+/**
+ * Sortuje stabilnie indeksy składników względem numerów ich grup
+ * (sortowanie przez zliczanie).
+ * @param[in] group : numery grup składników
+ * @param[in] groups : liczba grup
+ * @param[in] count : liczba składników
+ * @param[in,out] order : indeksy składników
+ * @param[in,out] temp : tablica pomocnicza na @p count indeksów
+ * @param[in,out] offsets : tablica pomocnicza na @p groups indeksów
+ */
+static void CountingSortByGroup(const size_t *group, size_t groups, size_t count,
+                                size_t *order, size_t *temp, size_t *offsets) {
+    memset(offsets, 0, groups * sizeof(size_t));
+    for (size_t i = 0; i < count; i++)
+        offsets[group[order[i]]]++;
+    size_t sum = 0;
+    for (size_t g = 0; g < groups; g++) {
+        size_t group_count = offsets[g];
+        offsets[g] = sum;
+        sum += group_count;
+    }
+    for (size_t i = 0; i < count; i++)
+        temp[offsets[group[order[i]]]++] = order[i];
+    memcpy(order, temp, count * sizeof(size_t));
+}
+
+void PolyBestVarOrder(const Poly *p, size_t k, size_t perm[]) {
+    for (size_t var = 0; var < k; var++)
+        perm[var] = var;
+    size_t count = PolyTermCount(p);
+    if (count == 0 || k < 2)
+        return;
+
+    poly_exp_t *exps = malloc(k * count * sizeof(poly_exp_t));
+    poly_coeff_t *coeffs = malloc(count * sizeof(poly_coeff_t));
+    size_t *indices = malloc(6 * count * sizeof(size_t));
+    unsigned *keys = malloc(2 * count * sizeof(unsigned));
+    bool *used = calloc(k, sizeof(bool));
+    if (exps == NULL || coeffs == NULL || indices == NULL || keys == NULL || used == NULL)
+        exit(1);
+    PolyToTerms(p, k, exps, coeffs);
+    size_t *order = indices, *candidate = indices + count, *best = indices + 2 * count;
+    size_t *temp = indices + 3 * count, *group = indices + 4 * count;
+    size_t *offsets = indices + 5 * count;
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+        group[i] = 0;
+    }
+
+    /* Zachłannie: na kolejnym poziomie zmienna, która daje najmniej różnych
+     * prefiksów wektorów wykładników, czyli najmniej jednomianów w drzewie */
+    size_t groups = 1;
+    for (size_t level = 0; level < k; level++) {
+        size_t best_var = k, best_groups = 0;
+        for (size_t var = 0; var < k; var++) {
+            if (used[var])
+                continue;
+            memcpy(candidate, order, count * sizeof(size_t));
+            RadixSortTermsByVar(exps, k, var, count, candidate, temp, keys);
+            CountingSortByGroup(group, groups, count, candidate, temp, offsets);
+            size_t distinct = 1;
+            for (size_t i = 1; i < count; i++)
+                distinct += group[candidate[i]] != group[candidate[i - 1]] ||
+                            exps[candidate[i] * k + var] != exps[candidate[i - 1] * k + var];
+            if (best_var == k || distinct < best_groups) {
+                best_var = var;
+                best_groups = distinct;
+                size_t *swap = best;
+                best = candidate;
+                candidate = swap;
             }
         }
-        return PolyZero();
+
+        used[best_var] = true;
+        perm[best_var] = level;
+        size_t *swap = order;
+        order = best;
+        best = swap;
+        size_t id = 0, prev_group = group[order[0]];
+        group[order[0]] = 0;
+        for (size_t i = 1; i < count; i++) {
+            size_t old_group = group[order[i]];
+            if (old_group != prev_group ||
+                exps[order[i] * k + best_var] != exps[order[i - 1] * k + best_var])
+                id++;
+            prev_group = old_group;
+            group[order[i]] = id;
+        }
+        groups = best_groups;
     }
+    free(exps);
+    free(coeffs);
+    free(indices);
+    free(keys);
+    free(used);
+}
 
-    Poly result, acc = PolyZero();
-    for (size_t i = 0; i < p->size; i++) {
-        result = ComposeHelper(&p->arr[i].p, poly_index, size, q);
-        Poly pow_res = QuickPolyPow(&q[poly_index], p->arr[i].exp);
-        Poly mul_res = PolyMul(&result, &pow_res);
-        PolyDestroy(&pow_res);
-        PolyDestroy(&result);
-        Poly add_res = PolyAdd(&acc, &mul_res);
-        PolyDestroy(&mul_res);
-        Poly old_acc = acc;
-        acc = add_res;
-        PolyDestroy(&old_acc);
+/**
+ * Podstawienie @f$x_i \to c \cdot x_{var}^{exp}@f$ rozpoznane przez
+ * @ref ComposeMonomials. Dla @f$exp = 0@f$ podstawiana jest stała @f$c@f$.
+ */
+typedef struct {
+    size_t var; ///< indeks zmiennej podstawianego jednomianu
+    poly_exp_t exp; ///< wykładnik podstawianego jednomianu
+    poly_coeff_t coeff; ///< współczynnik podstawianego jednomianu
+} MonoSubst;
+
+/**
+ * Sprawdza, czy wielomian jest stałą lub jednomianem postaci
+ * @f$c \cdot x_{var}^{exp}@f$, i jeśli tak, zapisuje jego postać.
+ * @param[in] q : wielomian
+ * @param[out] subst : postać jednomianu
+ * @return Czy wielomian jest stałą lub takim jednomianem?
+ */
+static bool PolyAsMonoSubst(const Poly *q, MonoSubst *subst) {
+    size_t var = 0;
+    while (PolyIsInner(q) && q->size == 1 && q->node->exps[0] == 0) {
+        q = &PolyCoeffs(q)[0];
+        var++;
     }
-    if (PolyIsNestedCoeff(&acc))
-        return PolyToCoeff(&acc);
-    return acc;
+    if (!PolyIsCoeff(q) && !PolyIsInline(q))
+        return false;
+    *subst = (MonoSubst) {.var = var, .exp = PolyIsCoeff(q) ? 0 : InlineExp(q),
+                          .coeff = q->coeff};
+    return true;
 }
 
-Poly PolyCompose(const Poly *p, size_t k, const Poly q[]) {
-    return ComposeHelper(p, COMPOSE_STARTING_INDEX, k, q);
-}
\ No newline at end of file
+/**
+ * Składa wielomian z wielomianami, które są stałymi lub jednomianami postaci
+ * @f$c \cdot x_j^e@f$. Każdy składnik postaci rozwiniętej @p p przechodzi
+ * wtedy na jeden składnik, więc wystarczy przepisać wykładniki
+ * i współczynniki w jednym przejściu i zbudować wielomian na nowo.
+ * @param[in] p : wielomian, który nie jest współczynnikiem
+ * @param[in] k : liczba wielomianów w tablicy @p q
+ * @param[in] q : tablica wielomianów
+ * @param[out] result : wynik złożenia, jeśli podstawienie jest jednomianowe
+ * @return Czy wszystkie wielomiany @p q są stałymi lub jednomianami?
+ */
+static bool ComposeMonomials(const Poly *p, size_t k, const Poly q[], Poly *result) {
+    MonoSubst *subst = malloc((k == 0 ? 1 : k) * sizeof(MonoSubst));
+    if (subst == NULL) exit(1);
+    size_t target_vars = 0;
+    for (size_t i = 0; i < k; i++) {
+        if (!PolyAsMonoSubst(&q[i], &subst[i])) {
+            free(subst);
+            return false;
+        }
+        if (subst[i].exp != 0 && subst[i].var >= target_vars)
+            target_vars = subst[i].var + 1;
+    }
+
+    size_t vars = PolyDepth(p), count = PolyTermCount(p);
+    poly_exp_t *exps = malloc(vars * count * sizeof(poly_exp_t));
+    poly_exp_t *new_exps = malloc((target_vars == 0 ? 1 : target_vars * count) *
+                                  sizeof(poly_exp_t));
+    poly_coeff_t *coeffs = malloc(count * sizeof(poly_coeff_t));
+    if (exps == NULL || new_exps == NULL || coeffs == NULL) exit(1);
+    PolyToTerms(p, vars, exps, coeffs);
+
+    size_t size = 0;
+    for (size_t t = 0; t < count; t++) {
+        poly_exp_t *row = new_exps + size * target_vars;
+        poly_coeff_t coeff = coeffs[t];
+        for (size_t var = 0; var < target_vars; var++)
+            row[var] = 0;
+        for (size_t var = 0; var < vars && coeff != 0; var++) {
+            poly_exp_t exp = exps[t * vars + var];
+            if (exp == 0)
+                continue;
+            /* Zmienne spoza tablicy q są zastępowane zerem */
+            if (var >= k) {
+                coeff = 0;
+                break;
+            }
+            coeff *= QuickPow(subst[var].coeff, exp);
+            if (subst[var].exp != 0)
+                row[subst[var].var] += subst[var].exp * exp;
+        }
+        if (coeff != 0)
+            coeffs[size++] = coeff;
+    }
+
+    size = SimplifyTerms(target_vars, size, new_exps, coeffs);
+    *result = TermsToPoly(target_vars, new_exps, coeffs, 0, size, 0);
+    free(subst);
+    free(exps);
+    free(new_exps);
+    free(coeffs);
+    return true;
+}
+
+/**
+ * Składa wielomian z wielomianami postaci @f$q_i = b_i x_i + a_i@f$.
+ * Zmienne o niezerowych @f$a_i@f$ i @f$b_i@f$ są przesuwane funkcją
+ * @ref PolyShift, zmienne spoza tablicy @p q są ustalane na zero, a na końcu
+ * zmienne są skalowane przez @ref ComposeMonomials.
+ * @param[in] p : wielomian, który nie jest współczynnikiem
+ * @param[in] k : liczba wielomianów w tablicy @p q
+ * @param[in] q : tablica wielomianów
+ * @param[out] result : wynik złożenia, jeśli wszystkie @f$q_i@f$ są takiej postaci
+ * @return Czy wszystkie wielomiany @p q są postaci @f$b_i x_i + a_i@f$?
+ */
+static bool ComposeAffine(const Poly *p, size_t k, const Poly q[], Poly *result) {
+    poly_coeff_t *shifts = malloc(2 * (k == 0 ? 1 : k) * sizeof(poly_coeff_t));
+    if (shifts == NULL) exit(1);
+    poly_coeff_t *scales = shifts + k;
+    for (size_t i = 0; i < k; i++) {
+        const Poly *var = &q[i];
+        size_t depth = 0;
+        while (PolyIsInner(var) && var->size == 1 && var->node->exps[0] == 0) {
+            var = &PolyCoeffs(var)[0];
+            depth++;
+        }
+        MonosView v;
+        MonosViewInit(&v, var);
+        bool affine = PolyIsCoeff(var) ||
+                      (depth == i && PolyIsFlat(var) && v.exps[v.size - 1] == 1 &&
+                       (v.size == 1 || (v.size == 2 && v.exps[0] == 0)));
+        if (!affine) {
+            free(shifts);
+            return false;
+        }
+        shifts[i] = PolyIsCoeff(var) ? var->coeff : v.size == 2 ? v.values[0] : 0;
+        scales[i] = PolyIsCoeff(var) ? 0 : v.values[v.size - 1];
+    }
+
+    /* Zmienne spoza tablicy q są zastępowane zerem */
+    Poly shifted;
+    size_t depth = PolyDepth(p);
+    if (depth > k) {
+        size_t *vars = malloc((depth - k) * sizeof(size_t));
+        poly_coeff_t *zeros = calloc(depth - k, sizeof(poly_coeff_t));
+        if (vars == NULL || zeros == NULL) exit(1);
+        for (size_t i = 0; i < depth - k; i++)
+            vars[i] = k + i;
+        shifted = PolyAtMany(p, depth - k, vars, zeros);
+        free(vars);
+        free(zeros);
+    }
+    else {
+        shifted = PolyClone(p);
+    }
+
+    /* p(b x + a) to p(x + a) po podstawieniu b x za x, a dla b = 0 po prostu
+     * p(a), więc stałe są pozostawione podstawieniu jednomianowemu */
+    bool scaled = false;
+    for (size_t i = 0; i < k; i++) {
+        if (scales[i] != 0 && shifts[i] != 0) {
+            Poly next = PolyShift(&shifted, i, shifts[i]);
+            PolyDestroy(&shifted);
+            shifted = next;
+        }
+        scaled |= scales[i] != 1;
+    }
+    if (!scaled || PolyIsCoeff(&shifted)) {
+        *result = shifted;
+        free(shifts);
+        return true;
+    }
+
+    Poly *monos = malloc(k * sizeof(Poly));
+    if (monos == NULL) exit(1);
+    for (size_t i = 0; i < k; i++)
+        monos[i] = scales[i] == 0 ? PolyFromCoeff(shifts[i])
+                                  : PolyLift(PolyFromTerm(scales[i], 1), i);
+    /* Wszystkie podstawienia są jednomianami, więc złożenie się powiedzie */
+    ComposeMonomials(&shifted, k, monos, result);
+    for (size_t i = 0; i < k; i++)
+        PolyDestroy(&monos[i]);
+    free(monos);
+    free(shifts);
+    PolyDestroy(&shifted);
+    return true;
+}
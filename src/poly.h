@@ -13,6 +13,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /** To jest typ reprezentujący współczynniki. */
 typedef long poly_coeff_t;
@@ -21,27 +22,69 @@ typedef long poly_coeff_t;
 typedef int poly_exp_t;
 
 struct Mono;
+struct PolyNode;
+
+#ifdef POLY_COMPACT_MONO
+
+/**
+ * To jest struktura przechowująca wielomian w zwartym układzie pamięci.
+ * Wielomian jest albo liczbą całkowitą, czyli wielomianem stałym
+ * (wtedy `size == 0`), albo niepustą listą jednomianów o niezerowych
+ * współczynnikach (wtedy `size != 0`).
+ * Struktura zajmuje 12 bajtów i nie jest wyrównywana, dzięki czemu jednomian
+ * zajmuje 16 bajtów zamiast 24. Jednomian postaci @f$c\cdot x^n@f$
+ * o liczbowym współczynniku jest przechowywany bez węzła: `coeff` zawiera
+ * wtedy @f$c@f$, a najstarszy bit `size` jest ustawiony, pozostałe zaś
+ * zawierają @f$n@f$. Liczba jednomianów musi być więc mniejsza od
+ * @f$2^{31}@f$.
+ */
+typedef struct __attribute__((packed)) Poly {
+    /**
+    * To jest unia przechowująca współczynnik wielomianu lub
+    * węzeł z jednomianami wielomianu.
+    */
+    union {
+        poly_coeff_t coeff; ///< współczynnik
+        struct PolyNode *node; ///< węzeł z jednomianami
+    };
+    /**
+     * To jest liczba jednomianów w wielomianie, 0 dla współczynnika lub
+     * wykładnik z ustawionym najstarszym bitem dla jednomianu bez węzła.
+     */
+    uint32_t size;
+} Poly;
+
+#else
 
 /**
  * To jest struktura przechowująca wielomian.
  * Wielomian jest albo liczbą całkowitą, czyli wielomianem stałym
- * (wtedy `arr == NULL`), albo niepustą listą jednomianów (wtedy `arr != NULL`).
+ * (wtedy `node == NULL`), albo niepustą listą jednomianów o niezerowych
+ * współczynnikach (wtedy `node != NULL`).
+ * Wykładniki i współczynniki jednomianów są przechowywane w węźle w osobnych
+ * tablicach, więc dostęp do jednomianów jest możliwy tylko przez funkcje
+ * @ref PolySize, @ref PolyGetMono i @ref PolyToMonos.
+ * Jednomian postaci @f$c\cdot x^n@f$ o liczbowym współczynniku jest
+ * przechowywany bez węzła: `coeff` zawiera wtedy @f$c@f$, a `node` nie jest
+ * wskaźnikiem, tylko wartością @f$2n + 1@f$.
  */
 typedef struct Poly {
     /**
     * To jest unia przechowująca współczynnik wielomianu lub
     * liczbę jednomianów w wielomianie.
-    * Jeżeli `arr == NULL`, wtedy jest to współczynnik będący liczbą całkowitą.
+    * Jeżeli `node == NULL`, wtedy jest to współczynnik będący liczbą całkowitą.
     * W przeciwnym przypadku jest to niepusta lista jednomianów.
     */
     union {
         poly_coeff_t coeff; ///< współczynnik
         size_t size; ///< rozmiar wielomianu, liczba jednomianów
     };
-    /** To jest tablica przechowująca listę jednomianów. */
-    struct Mono *arr;
+    /** To jest węzeł przechowujący listę jednomianów. */
+    struct PolyNode *node;
 } Poly;
 
+#endif /* POLY_COMPACT_MONO */
+
 /**
  * To jest struktura przechowująca jednomian.
  * Jednomian ma postać @f$px_i^n@f$.
@@ -68,7 +111,11 @@ static inline poly_exp_t MonoGetExp(const Mono *m) {
  * @return wielomian
  */
 static inline Poly PolyFromCoeff(poly_coeff_t c) {
-    return (Poly) {.coeff = c, .arr = NULL};
+#ifdef POLY_COMPACT_MONO
+    return (Poly) {.coeff = c, .size = 0};
+#else
+    return (Poly) {.coeff = c, .node = NULL};
+#endif
 }
 
 /**
@@ -99,17 +146,23 @@ static inline Mono MonoFromPoly(const Poly *p, poly_exp_t n) {
  * @return Czy wielomian jest współczynnikiem?
  */
 static inline bool PolyIsCoeff(const Poly *p) {
-    return p->arr == NULL;
+#ifdef POLY_COMPACT_MONO
+    return p->size == 0;
+#else
+    return p->node == NULL;
+#endif
 }
 
 /**
  * Sprawdza, czy wielomian jest tożsamościowo równy zeru.
+ * Wielomian, który nie jest współczynnikiem, zawsze ma niezerowy jednomian,
+ * więc wystarczy sprawdzić współczynnik i nie trzeba schodzić w głąb
+ * wielomianu.
  * @param[in] p : wielomian
  * @return Czy wielomian jest równy zeru?
  */
 static inline bool PolyIsZero(const Poly *p) {
-    return (PolyIsCoeff(p) && p->coeff == 0) ||
-           ((p->arr != NULL) && (p->size == 1 && PolyIsZero(&p->arr[0].p)));
+    return PolyIsCoeff(p) && p->coeff == 0;
 }
 
 /**
@@ -190,6 +243,33 @@ Poly PolyOwnMonos(size_t count, Mono *monos);
  */
 Poly PolyCloneMonos(size_t count, const Mono monos[]);
 
+/**
+ * Daje liczbę jednomianów wielomianu (0 dla współczynnika).
+ * @param[in] p : wielomian
+ * @return liczba jednomianów
+ */
+size_t PolySize(const Poly *p);
+
+/**
+ * Daje jednomian wielomianu o indeksie @p i. Jednomiany są uporządkowane
+ * rosnąco względem wykładników. Współczynnik zwróconego jednomianu należy do
+ * wielomianu @p p - nie wolno go modyfikować ani usuwać.
+ * @param[in] p : wielomian, który nie jest współczynnikiem
+ * @param[in] i : indeks jednomianu, mniejszy od @ref PolySize
+ * @return jednomian
+ */
+Mono PolyGetMono(const Poly *p, size_t i);
+
+/**
+ * Zamienia wielomian na tablicę jednomianów zaalokowaną na stercie.
+ * Jednomiany są pełnymi kopiami, a tablicę można przekazać funkcji
+ * @ref PolyOwnMonos. Dla wielomianu tożsamościowo równego zeru zwraca NULL.
+ * @param[in] p : wielomian
+ * @param[out] count : liczba jednomianów w tablicy
+ * @return tablica jednomianów
+ */
+Mono *PolyToMonos(const Poly *p, size_t *count);
+
 /**
  * Mnoży dwa wielomiany.
  * @param[in] p : wielomian @f$p@f$
@@ -198,6 +278,144 @@ Poly PolyCloneMonos(size_t count, const Mono monos[]);
  */
 Poly PolyMul(const Poly *p, const Poly *q);
 
+/**
+ * Dodaje do wielomianu @p r iloczyn dwóch wielomianów. Iloczyny par
+ * jednomianów są sumowane bezpośrednio z jednomianami @p r, bez tworzenia
+ * wielomianu @f$p * q@f$. Poprzednia wartość @p r zostaje zastąpiona wynikiem
+ * (i usunięta), więc funkcja nadaje się do sumowania iloczynów w pętli.
+ * @param[in,out] r : wielomian @f$r@f$
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ */
+void PolyMulAdd(Poly *r, const Poly *p, const Poly *q);
+
+/**
+ * Mnoży wielomian przez jednomian @f$c \cdot x_{var\_idx}^e@f$ w miejscu.
+ * Wykładniki zmiennej @f$x_{var\_idx}@f$ są zwiększane o @p e, a liczbowe
+ * współczynniki mnożone przez @p c w jednym przejściu drzewa, bez budowania
+ * jednomianu i mnożenia wielomianów. Węzły wielomianu są wykorzystywane
+ * ponownie, a dla @f$c = 1@f$ poddrzewa poniżej zmiennej nie są odwiedzane.
+ * Poprzednia wartość @p p zostaje zastąpiona wynikiem.
+ * @param[in,out] p : wielomian @f$p@f$
+ * @param[in] var_idx : indeks zmiennej
+ * @param[in] e : nieujemny wykładnik
+ * @param[in] c : współczynnik
+ */
+void PolyMulMono(Poly *p, size_t var_idx, poly_exp_t e, poly_coeff_t c);
+
+/**
+ * Obcina wielomian do jednomianów, których stopień (suma wykładników
+ * wszystkich zmiennych) nie przekracza @p d. Dla ujemnego @p d daje zero.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] d : ograniczenie stopnia
+ * @return jednomiany @f$p@f$ stopnia co najwyżej @p d
+ */
+Poly PolyTruncate(const Poly *p, poly_exp_t d);
+
+/**
+ * Mnoży dwa wielomiany, licząc tylko jednomiany iloczynu stopnia co najwyżej
+ * @p d, tak jak przy mnożeniu szeregów potęgowych. Iloczyny par jednomianów,
+ * których wykładniki przekraczają ograniczenie, są pomijane bez liczenia:
+ * wykładniki są posortowane, więc pętle kończą się na pierwszym zbyt dużym.
+ * Jeśli suma stopni czynników nie przekracza @p d, działa jak @ref PolyMul.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @param[in] d : ograniczenie stopnia
+ * @return @f$p \cdot q@f$ obcięty do stopnia @p d
+ */
+Poly PolyMulTrunc(const Poly *p, const Poly *q, poly_exp_t d);
+
+/**
+ * Podnosi wielomian do potęgi, obcinając do stopnia @p d wszystkie iloczyny
+ * pośrednie (patrz @ref PolyMulTrunc).
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] n : nieujemny wykładnik potęgi
+ * @param[in] d : ograniczenie stopnia
+ * @return @f$p^n@f$ obcięty do stopnia @p d
+ */
+Poly PolyPowTrunc(const Poly *p, poly_exp_t n, poly_exp_t d);
+
+/**
+ * Wylicza odwrotność szeregu potęgowego @f$f@f$ zmiennej @f$x_0@f$ modulo
+ * @f$x^n@f$, czyli szereg @f$g@f$ taki, że @f$fg \equiv 1@f$. Działa metodą
+ * Newtona z podwajaniem dokładności, więc kosztuje tyle co stała liczba
+ * mnożeń (patrz @ref PolyMulTrunc). Współczynniki są liczone modulo @p m,
+ * a dla @f$m = 0@f$ - tak jak w pozostałych działaniach, modulo @f$2^{64}@f$.
+ * Odwrotność istnieje, gdy wyraz wolny jest odwracalny: względnie pierwszy
+ * z @p m lub, dla @f$m = 0@f$, nieparzysty.
+ * @param[in] p : wielomian zmiennej @f$x_0@f$
+ * @param[in] n : nieujemna liczba współczynników wyniku
+ * @param[in] m : moduł: 0 lub liczba od 2 do @f$2^{31} - 1@f$
+ * @param[out] result : współczynniki odwrotności przy @f$x^0, \ldots,
+ * x^{n-1}@f$ sprowadzone do przedziału @f$[0, m)@f$, jeśli @f$m > 0@f$
+ * @return Czy @p p jest wielomianem jednej zmiennej, którego odwrotność
+ * istnieje?
+ */
+bool PolySeriesInv(const Poly *p, poly_exp_t n, poly_coeff_t m, Poly *result);
+
+/**
+ * Wylicza pierwiastek kwadratowy szeregu potęgowego @f$f@f$ zmiennej
+ * @f$x_0@f$ o wyrazie wolnym 1 modulo @f$x^n@f$, czyli szereg @f$g@f$
+ * o wyrazie wolnym 1 taki, że @f$g^2 \equiv f@f$ (patrz
+ * @ref PolySeriesInv). Modulo @f$m > 0@f$ moduł musi być nieparzysty.
+ * Modulo @f$2^{64}@f$ nie można dzielić przez 2, więc pozostałe
+ * współczynniki @f$f@f$ muszą być podzielne przez 4; wtedy pierwiastek ma
+ * współczynniki całkowite.
+ * @param[in] p : wielomian zmiennej @f$x_0@f$
+ * @param[in] n : nieujemna liczba współczynników wyniku
+ * @param[in] m : moduł: 0 lub liczba od 2 do @f$2^{31} - 1@f$
+ * @param[out] result : pierwiastek
+ * @return Czy @p p jest wielomianem jednej zmiennej, którego pierwiastek
+ * istnieje?
+ */
+bool PolySeriesSqrt(const Poly *p, poly_exp_t n, poly_coeff_t m, Poly *result);
+
+/**
+ * Wylicza eksponentę szeregu potęgowego @f$f@f$ zmiennej @f$x_0@f$
+ * o zerowym wyrazie wolnym modulo @f$x^n@f$ (patrz @ref PolySeriesInv).
+ * Współczynniki eksponenty mają w mianownikach silnie, dlatego jest ona
+ * liczona tylko modulo @f$m > 0@f$, w którym liczby @f$1, \ldots, n - 1@f$
+ * są odwracalne, na przykład modulo liczby pierwszej @f$m \geq n@f$.
+ * @param[in] p : wielomian zmiennej @f$x_0@f$
+ * @param[in] n : nieujemna liczba współczynników wyniku
+ * @param[in] m : moduł: 0 lub liczba od 2 do @f$2^{31} - 1@f$
+ * @param[out] result : eksponenta
+ * @return Czy @p p jest wielomianem jednej zmiennej, którego eksponenta
+ * istnieje?
+ */
+bool PolySeriesExp(const Poly *p, poly_exp_t n, poly_coeff_t m, Poly *result);
+
+/**
+ * Sumuje tablicę wielomianów. Na każdym poziomie rekurencji jednomiany
+ * wszystkich wielomianów są scalane naraz za pomocą kopca, bez tworzenia sum
+ * częściowych.
+ * @param[in] count : liczba wielomianów
+ * @param[in] p : tablica wielomianów
+ * @return @f$\sum_i p_i@f$
+ */
+Poly PolyAddMany(size_t count, const Poly p[]);
+
+/**
+ * Liczy kombinację liniową wielomianów @f$\sum_i c_i \cdot p_i@f$. Wszystkie
+ * wielomiany są scalane naraz, bez tworzenia sum częściowych.
+ * @param[in] count : liczba wielomianów
+ * @param[in] c : tablica współczynników @f$c_i@f$
+ * @param[in] p : tablica wielomianów @f$p_i@f$
+ * @return @f$\sum_i c_i \cdot p_i@f$
+ */
+Poly PolyLinearCombination(size_t count, const poly_coeff_t c[], const Poly p[]);
+
+/**
+ * Liczy iloczyn skalarny tablic wielomianów @f$\sum_i p_i \cdot q_i@f$.
+ * Jednomiany wszystkich iloczynów są scalane naraz, bez tworzenia iloczynów
+ * ani sum częściowych.
+ * @param[in] count : liczba par wielomianów
+ * @param[in] p : tablica wielomianów @f$p_i@f$
+ * @param[in] q : tablica wielomianów @f$q_i@f$
+ * @return @f$\sum_i p_i \cdot q_i@f$
+ */
+Poly PolyDotProduct(size_t count, const Poly p[], const Poly q[]);
+
 /**
  * Zwraca przeciwny wielomian.
  * @param[in] p : wielomian @f$p@f$
@@ -213,6 +431,35 @@ Poly PolyNeg(const Poly *p);
  */
 Poly PolySub(const Poly *p, const Poly *q);
 
+/**
+ * Dzieli wielomian @f$p@f$ z resztą przez wielomian @f$d@f$ unormowany
+ * względem zmiennej głównej, czyli taki, że współczynnik przy najwyższej
+ * potędze @f$x_0@f$ jest równy 1. Wyznacza takie @f$q@f$ i @f$r@f$, że
+ * @f$p = qd + r@f$ i stopień @f$r@f$ względem @f$x_0@f$ jest mniejszy od
+ * stopnia @f$d@f$. Jednomiany ilorazu powstają kolejno od najwyższego
+ * wykładnika, a iloczyny @f$qd@f$ są scalane kopcem, bez odejmowania całych
+ * wielomianów.
+ * @param[in] p : dzielna @f$p@f$
+ * @param[in] d : dzielnik @f$d@f$
+ * @param[out] q : iloraz @f$q@f$
+ * @param[out] r : reszta @f$r@f$
+ * @return Czy @f$d@f$ jest unormowany względem @f$x_0@f$? Jeśli nie, @p q
+ * i @p r nie są zmieniane.
+ */
+bool PolyDivRem(const Poly *p, const Poly *d, Poly *q, Poly *r);
+
+/**
+ * Dzieli wielomian @f$p@f$ przez wielomian @f$d@f$ unormowany względem
+ * zmiennej głównej bez reszty (patrz @ref PolyDivRem). Dzielenie kończy się
+ * na pierwszym niezerowym jednomianie reszty.
+ * @param[in] p : dzielna @f$p@f$
+ * @param[in] d : dzielnik @f$d@f$
+ * @param[out] q : iloraz @f$p / d@f$
+ * @return Czy @f$d@f$ jest unormowany względem @f$x_0@f$ i dzieli @f$p@f$?
+ * Jeśli nie, @p q nie jest zmieniany.
+ */
+bool PolyDivExact(const Poly *p, const Poly *d, Poly *q);
+
 /**
  * Zwraca stopień wielomianu ze względu na zadaną zmienną (-1 dla wielomianu
  * tożsamościowo równego zeru). Zmienne indeksowane są od 0.
@@ -253,6 +500,34 @@ bool PolyIsEq(const Poly *p, const Poly *q);
  */
 Poly PolyAt(const Poly *p, poly_coeff_t x);
 
+/**
+ * Podstawia @f$x_{var\_idx} + a@f$ za zmienną @f$x_{var\_idx}@f$ (przesunięcie
+ * Taylora). Poziomy powyżej zmiennej są przepisywane bez obliczeń. Poziom
+ * o liczbowych współczynnikach jest przesuwany w miejscu schematem Hornera
+ * w czasie @f$O(n^2)@f$ dla stopnia @f$n@f$, a poziom o współczynnikach
+ * wielomianowych metodą dziel i zwyciężaj, wymagającą @f$O(n)@f$ mnożeń
+ * i dodawań współczynników zamiast @f$O(n^2)@f$.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] var_idx : indeks zmiennej
+ * @param[in] a : przesunięcie @f$a@f$
+ * @return @f$p(x_0, \ldots, x_{var\_idx} + a, \ldots)@f$
+ */
+Poly PolyShift(const Poly *p, size_t var_idx, poly_coeff_t a);
+
+/**
+ * Wylicza wartość wielomianu w punktach @f$a_0, \ldots, a_{k-1}@f$ dla
+ * zmiennych o indeksach @f$i_0 < i_1 < \ldots < i_{k-1}@f$ w jednym
+ * przejściu drzewa. Pozostałe zmienne są przenumerowywane kolejno, tak jak
+ * po wywołaniach @ref PolyAt dla kolejnych ustalanych zmiennych. Poddrzewa
+ * poniżej ostatniej ustalanej zmiennej nie są przebudowywane.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] k : liczba ustalanych zmiennych
+ * @param[in] vars : rosnące indeksy zmiennych @f$i_0, \ldots, i_{k-1}@f$
+ * @param[in] values : wartości @f$a_0, \ldots, a_{k-1}@f$
+ * @return wielomian pozostałych zmiennych
+ */
+Poly PolyAtMany(const Poly *p, size_t k, const size_t vars[], const poly_coeff_t values[]);
+
 /**
  * Składa wielomiany z tablicy @p q do wielomianu @p p.
  * @param p : wielomian @f$p@f$
@@ -262,4 +537,194 @@ Poly PolyAt(const Poly *p, poly_coeff_t x);
  */
 Poly PolyCompose(const Poly *p, size_t k, const Poly q[]);
 
+/**
+ * Składa wielomiany z tablicy @p q do wielomianu @p p, licząc tylko jednomiany
+ * wyniku stopnia co najwyżej @p d. Wyniki pośrednie są obcinane na bieżąco
+ * (patrz @ref PolyMulTrunc), a jednomiany @p p, których potęgi podstawianych
+ * wielomianów obcinają się do zera, są pomijane.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] k : liczba wielomianów w tablicy @p q
+ * @param[in] q : tablica wielomianów @f$q_0, q_1, \ldots, q_{k-1}@f$
+ * @param[in] d : ograniczenie stopnia
+ * @return @f$p(q_0, q_1, \ldots, q_{k-1})@f$ obcięty do stopnia @p d
+ */
+Poly PolyComposeTrunc(const Poly *p, size_t k, const Poly q[], poly_exp_t d);
+
+/**
+ * Podstawia wielomian @f$q@f$ za zmienną @f$x_{var\_idx}@f$. Przebudowuje tylko
+ * poziomy od korzenia do zmiennej @f$x_{var\_idx}@f$, a głębsze poddrzewa
+ * kopiuje. Jeśli @f$q@f$ nie zależy od zmiennych @f$x_0, \ldots,
+ * x_{var\_idx - 1}@f$, poziomy powyżej zmiennej są przepisywane bez mnożeń.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] var_idx : indeks zmiennej
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p(x_0, \ldots, x_{var\_idx - 1}, q, x_{var\_idx + 1}, \ldots)@f$
+ */
+Poly PolySubstitute(const Poly *p, size_t var_idx, const Poly *q);
+
+/**
+ * To jest struktura budująca wielomian ze składników postaci
+ * @f$c \cdot x_0^{e_0} x_1^{e_1} \cdots x_{k-1}^{e_{k-1}}@f$ dodawanych po
+ * jednym. Zajmuje pamięć proporcjonalną do liczby różnych wektorów
+ * wykładników, a nie wszystkich dodanych składników.
+ */
+typedef struct PolyBuilder PolyBuilder;
+
+/**
+ * Tworzy pusty budowniczy wielomianu @p vars zmiennych.
+ * @param[in] vars : liczba zmiennych @f$k@f$
+ * @return budowniczy, którego należy zakończyć funkcją @ref PolyBuilderFinish
+ */
+PolyBuilder *PolyBuilderNew(size_t vars);
+
+/**
+ * Dodaje składnik do budowanego wielomianu. Składniki mogą być dodawane
+ * w dowolnej kolejności i mogą mieć równe wektory wykładników.
+ * @param[in,out] b : budowniczy
+ * @param[in] exps : nieujemne wykładniki @f$e_0, \ldots, e_{k-1}@f$
+ * @param[in] c : współczynnik @f$c@f$
+ */
+void PolyBuilderAdd(PolyBuilder *b, const poly_exp_t exps[], poly_coeff_t c);
+
+/**
+ * Tworzy wielomian będący sumą dodanych składników i usuwa budowniczego.
+ * @param[in] b : budowniczy
+ * @return suma dodanych składników
+ */
+Poly PolyBuilderFinish(PolyBuilder *b);
+
+/**
+ * Tworzy wielomian z tablicy składników postaci
+ * @f$c \cdot x_0^{e_0} x_1^{e_1} \cdots x_{k-1}^{e_{k-1}}@f$. Składniki mogą
+ * być podane w dowolnej kolejności i mogą mieć równe wektory wykładników.
+ * Działa w czasie liniowym względem rozmiaru danych dla składników
+ * posortowanych leksykograficznie i w czasie @f$O(n \log n)@f$ w ogólności.
+ * @param[in] vars : liczba zmiennych @f$k@f$
+ * @param[in] count : liczba składników @f$n@f$
+ * @param[in] exps : nieujemne wykładniki, po @f$k@f$ kolejnych na składnik
+ * @param[in] coeffs : współczynniki składników
+ * @return suma składników
+ */
+Poly PolyFromTerms(size_t vars, size_t count, const poly_exp_t exps[],
+                   const poly_coeff_t coeffs[]);
+
+/**
+ * Daje współczynnik przy składniku @f$x_0^{e_0} x_1^{e_1} \cdots x_{k-1}^{e_{k-1}}@f$
+ * postaci rozwiniętej wielomianu, czyli współczynnik jednomianu, w którym
+ * pozostałe zmienne występują w potędze zerowej. Na każdym poziomie drzewa
+ * wyszukuje wykładnik binarnie, więc działa w czasie
+ * @f$O(d \log n)@f$, gdzie @f$d@f$ to głębokość wielomianu. Nie alokuje pamięci.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wykładników
+ * @param[in] exps : nieujemne wykładniki @f$e_0, \ldots, e_{k-1}@f$
+ * @return współczynnik składnika lub 0, jeśli wielomian go nie zawiera
+ */
+poly_coeff_t PolyCoeffOf(const Poly *p, size_t k, const poly_exp_t exps[]);
+
+/**
+ * Daje liczbę składników wielomianu w postaci rozwiniętej, czyli liczbę
+ * wierszy potrzebnych w tablicach przekazywanych do @ref PolyToTerms.
+ * @param[in] p : wielomian
+ * @return liczba składników o niezerowych współczynnikach
+ */
+size_t PolyTermCount(const Poly *p);
+
+/**
+ * Zapisuje składniki wielomianu w postaci rozwiniętej do tablic podanych przez
+ * wywołującego, w porządku leksykograficznym wektorów wykładników. Tablice
+ * muszą pomieścić @ref PolyTermCount składników, a wielomian może zależeć
+ * tylko od zmiennych @f$x_0, \ldots, x_{k-1}@f$. Nie alokuje pamięci.
+ * @param[in] p : wielomian
+ * @param[in] vars : liczba zmiennych @f$k@f$
+ * @param[out] exps : wykładniki, po @f$k@f$ kolejnych na składnik
+ * @param[out] coeffs : współczynniki składników
+ * @return liczba zapisanych składników
+ */
+size_t PolyToTerms(const Poly *p, size_t vars, poly_exp_t exps[], poly_coeff_t coeffs[]);
+
+/**
+ * Zmienia kolejność zmiennych wielomianu: zmienna @f$x_i@f$ przechodzi na
+ * @f$x_{perm[i]}@f$. Wielomian jest spłaszczany do postaci rozwiniętej,
+ * a następnie budowany na nowo po jednym sortowaniu składników, więc
+ * działa w czasie @f$O(k n)@f$ dla @f$n@f$ składników.
+ * @param[in] p : wielomian zależny tylko od zmiennych @f$x_0, \ldots, x_{k-1}@f$
+ * @param[in] k : liczba zmiennych
+ * @param[in] perm : permutacja liczb @f$0, \ldots, k-1@f$
+ * @return @f$p@f$ po przenumerowaniu zmiennych
+ */
+Poly PolyPermuteVars(const Poly *p, size_t k, const size_t perm[]);
+
+/**
+ * Wyznacza kolejność zmiennych, w której reprezentacja rekurencyjna wielomianu
+ * jest możliwie mała. Zmienne są wybierane zachłannie od korzenia: na każdym
+ * poziomie ta, która daje najmniej różnych prefiksów wektorów wykładników,
+ * czyli najmniej jednomianów na tym poziomie. Przy równej liczbie wygrywa
+ * zmienna o mniejszym indeksie, więc kolejność zmienia się tylko wtedy, gdy
+ * zmniejsza to drzewo.
+ * @param[in] p : wielomian zależny tylko od zmiennych @f$x_0, \ldots, x_{k-1}@f$
+ * @param[in] k : liczba zmiennych
+ * @param[out] perm : permutacja do przekazania @ref PolyPermuteVars
+ */
+void PolyBestVarOrder(const Poly *p, size_t k, size_t perm[]);
+
+/**
+ * Daje liczbę poziomów zagnieżdżenia wielomianu, czyli długość najdłuższej
+ * ścieżki od korzenia do współczynnika będącego liczbą. Tyle poziomów stosu
+ * potrzebuje @ref PolyTermIter. Dla wielomianu stałego wynosi 0.
+ * @param[in] p : wielomian
+ * @return liczba poziomów zagnieżdżenia
+ */
+size_t PolyDepth(const Poly *p);
+
+/**
+ * To jest poziom stosu @ref PolyTermIter. Jego pola są prywatne.
+ */
+typedef struct PolyTermFrame {
+    const Poly *p; ///< wielomian na tym poziomie
+    size_t index; ///< indeks bieżącego jednomianu
+} PolyTermFrame;
+
+/**
+ * To jest iterator po składnikach wielomianu w postaci rozwiniętej,
+ * w porządku leksykograficznym wektorów wykładników. Korzysta wyłącznie ze
+ * stosu podanego przez wywołującego i nie alokuje pamięci. Po każdym
+ * udanym wywołaniu @ref PolyTermIterNext bieżący składnik to
+ * @f$coeff \cdot x_0^{exps[0]} \cdots x_{depth-1}^{exps[depth-1]}@f$.
+ * Pola @p shared i @p next_shared opisują strukturę drzewa: pozwalają na
+ * przykład wypisać wielomian w postaci zagnieżdżonej bez rekurencji.
+ */
+typedef struct PolyTermIter {
+    PolyTermFrame *frames; ///< stos iteratora
+    poly_exp_t *exps; ///< wykładniki bieżącego składnika
+    size_t capacity; ///< liczba poziomów stosu
+    size_t depth; ///< liczba zmiennych na ścieżce bieżącego składnika
+    /** liczba początkowych jednomianów ścieżki wspólnych z poprzednim składnikiem */
+    size_t shared;
+    /** liczba początkowych jednomianów ścieżki wspólnych z następnym składnikiem */
+    size_t next_shared;
+    poly_coeff_t coeff; ///< współczynnik bieżącego składnika
+    bool has_next; ///< czy istnieje następny składnik
+    bool started; ///< czy iterator zwrócił już pierwszy składnik
+    const Poly *root; ///< przeglądany wielomian
+} PolyTermIter;
+
+/**
+ * Inicjuje iterator po składnikach wielomianu. Wielomian nie może być
+ * zmieniany ani usuwany w trakcie iteracji.
+ * @param[out] it : iterator
+ * @param[in] p : wielomian
+ * @param[in] frames : stos o co najmniej @ref PolyDepth poziomach
+ * @param[in] exps : tablica na co najmniej @ref PolyDepth wykładników
+ * @param[in] capacity : liczba poziomów stosu i miejsc w tablicy @p exps
+ */
+void PolyTermIterInit(PolyTermIter *it, const Poly *p, PolyTermFrame frames[],
+                      poly_exp_t exps[], size_t capacity);
+
+/**
+ * Przechodzi do następnego składnika.
+ * @param[in,out] it : iterator
+ * @return Czy istnieje kolejny składnik?
+ */
+bool PolyTermIterNext(PolyTermIter *it);
+
 #endif /* __POLY_H__ */
@@ -71,6 +71,17 @@ size_t CountMonos(const char *line) {
 
 static bool ParsePoly(Poly *p, char *line, size_t line_length, char **endptr);
 
+/**
+ * Usuwa z pamięci jednomiany z tablicy @p monos oraz samą tablicę.
+ * @param[in] monos : tablica jednomianów
+ * @param[in] count : liczba jednomianów w tablicy
+ */
+static void DestroyMonos(Mono *monos, size_t count) {
+    for (size_t i = 0; i < count; i++)
+        MonoDestroy(&monos[i]);
+    free(monos);
+}
+
 /**
  * Przetwarza początkowe znaki ciągu na jednomian. Zwraca @p false, jeśli
  * w zapisie jednomianu występuje błąd, w przeczwnym przypadku zwraca @p true.
@@ -149,23 +160,21 @@ bool ParseCoeff(Poly *p, char *line, char **endptr) {
  * @return Czy operacja się powiodła?
  */
 static bool ParsePoly(Poly *p, char *line, size_t line_length, char **endptr) {
-    p->arr = NULL;
-    p->size = 0;
-    p->coeff = 0;
+    *p = PolyZero();
     /* Jeśli zaczyna się od liczby, musi być współczynnikiem. */
     if (line_length > 0 && (isdigit(line[0]) || line[0] == '-'))
         return ParseCoeff(p, line, endptr);
 
     bool plus = false;
     size_t index = 0;
-    size_t monos_size = CountMonos(line);
-    p->arr = SafeMonoMalloc(monos_size);
+    size_t count = 0;
+    Mono *monos = SafeMonoMalloc(CountMonos(line));
     while (index < line_length && line[index] != '\0' && line[index] != ',') {
         /* Jeśli obecnym znakiem powinien być + */
         if (plus) {
             *endptr = (line + index);
             if (line[index] != '+' || (line[index] == '+' && line[index + 1] != '(')) {
-                PolyDestroy(p);
+                DestroyMonos(monos, count);
                 return false;
             }
             else
@@ -174,23 +183,20 @@ static bool ParsePoly(Poly *p, char *line, size_t line_length, char **endptr) {
         Mono m;
         bool op = ParseMono(&m, (line + index), line_length - index, endptr);
         if (!op) {
-            if (p->arr != NULL)
-                PolyDestroy(p);
+            DestroyMonos(monos, count);
             return false;
         }
-        p->arr[p->size++] = m;
+        monos[count++] = m;
         index = *endptr - line;
         plus = true;
     }
     *endptr = (line + index);
     if (line[index] != ',' && line[index] != '\0') {
-        PolyDestroy(p);
+        DestroyMonos(monos, count);
         return false;
     }
     else {
-        Poly new_p = PolyAddMonos(p->size, p->arr);
-        free(p->arr);
-        *p = new_p;
+        *p = PolyOwnMonos(count, monos);
         return true;
     }
 }
@@ -3043,6 +3043,205 @@ static bool SimpleAddMonosTest(void) {
   return res;
 }
 
+/**
+ * Sprawdza PolyAddMonos dla tablic jednomianów w różnej kolejności: posortowanej,
+ * odwróconej, złożonej z kilku posortowanych serii i pomieszanej.
+ * Wykładniki się powtarzają, a część jednomianów się redukuje.
+ */
+static bool AddMonosOrderTest(void) {
+  const size_t size = 20000;
+  const size_t orders = 4;
+  bool res = true;
+  Poly expected = PolyZero();
+  for (size_t order = 0; order < orders; ++order) {
+    Mono *m = calloc(size, sizeof (Mono));
+    CHECK_PTR(m);
+    for (size_t i = 0; i < size; ++i) {
+      size_t k;
+      if (order == 0)
+        k = i;
+      else if (order == 1)
+        k = size - 1 - i;
+      else if (order == 2)
+        k = (i + size / 3) % size;
+      else
+        k = (i * 7919) % size;
+      // Wykładnik k / 2 występuje dwa razy, wyrazy 2j i 2j + 1 dla j
+      // podzielnego przez 3 się redukują
+      poly_exp_t exp = (poly_exp_t)(k / 2) * 1000;
+      poly_coeff_t coeff = (k / 2) % 3 == 0 && k % 2 == 1 ? -1 : 1;
+      m[i] = M(P(C(coeff), (poly_exp_t)(k / 2) % 3), exp);
+    }
+    Poly p = PolyAddMonos(size, m);
+    if (order == 0)
+      expected = p;
+    else {
+      res &= PolyIsEq(&p, &expected);
+      PolyDestroy(&p);
+    }
+    free(m);
+  }
+  res &= PolyDeg(&expected) == (poly_exp_t)(size / 2 - 2) * 1000 + 2;
+  PolyDestroy(&expected);
+  return res;
+}
+
+/**
+ * Sprawdza PolyOwnMonos i PolyCloneMonos. PolyCloneMonos nie może współdzielić
+ * pamięci z tablicą wejściową, a PolyOwnMonos musi zwolnić przekazaną tablicę.
+ * Uruchomienie pod valgrindem nie powinno zgłaszać wycieków pamięci.
+ */
+static bool OwnCloneMonosTest(void) {
+  bool res = true;
+  Mono m[] = {M(P(C(1), 2), 3), M(C(5), 0), M(P(C(-1), 2), 3), M(P(C(2), 1), 3),
+              M(C(0), 0), M(P(C(7), 1), 1)};
+  const size_t count = sizeof (m) / sizeof (m[0]);
+  Poly expected = P(C(5), 0, P(C(7), 1), 1, P(C(2), 1), 3);
+  Poly p = PolyCloneMonos(count, m);
+  res &= PolyIsEq(&p, &expected);
+  Mono *own = malloc(count * sizeof (Mono));
+  CHECK_PTR(own);
+  for (size_t i = 0; i < count; ++i)
+    own[i] = m[i];
+  Poly q = PolyOwnMonos(count, own);
+  res &= PolyIsEq(&q, &expected);
+  Poly zero = PolyOwnMonos(0, NULL);
+  res &= PolyIsZero(&zero);
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+  PolyDestroy(&expected);
+  return res;
+}
+
+static bool MonosConversionTest(void) {
+  bool res = true;
+  Poly polys[] = {C(0), C(-3), P(C(1), 2), P(C(5), 0, P(C(7), 1), 1, P(C(2), 1), 3),
+                  P(P(P(C(1), 4), 0, C(2), 5), 1, C(-1), 6)};
+  for (size_t i = 0; i < sizeof (polys) / sizeof (polys[0]); ++i) {
+    Poly *p = &polys[i];
+    poly_exp_t prev_exp = -1;
+    for (size_t j = 0; j < PolySize(p); ++j) {
+      Mono m = PolyGetMono(p, j);
+      res &= MonoGetExp(&m) > prev_exp && !PolyIsZero(&m.p);
+      prev_exp = MonoGetExp(&m);
+    }
+    size_t count;
+    Mono *monos = PolyToMonos(p, &count);
+    res &= count == (PolyIsCoeff(p) ? !PolyIsZero(p) : PolySize(p));
+    Poly q = PolyOwnMonos(count, monos);
+    res &= PolyIsEq(p, &q);
+    PolyDestroy(&q);
+    PolyDestroy(p);
+  }
+  return res;
+}
+
+static bool LeafKernelsTest(void) {
+  bool res = true;
+  res &= TestMul(P(C(1), 0, C(1), 1000000),
+                 P(C(-1), 0, C(1), 1000000),
+                 P(C(-1), 0, C(1), 2000000));
+  res &= TestMul(P(C(1), 0, C(1), 1),
+                 P(C(1), 0, C(1), 1),
+                 P(C(1), 0, C(2), 1, C(1), 2));
+  res &= TestMul(P(C(1), 1, C(-1), 2),
+                 P(C(1), 1, C(1), 2),
+                 P(C(1), 2, C(-1), 4));
+  res &= TestMul(P(C(2), 3, C(5), 7),
+                 C(-3),
+                 P(C(-6), 3, C(-15), 7));
+  res &= TestAdd(P(C(1), 0, C(1), 1),
+                 C(-1),
+                 P(C(1), 1));
+  res &= TestAdd(P(C(2), 0, C(1), 1),
+                 P(C(-1), 1),
+                 C(2));
+  res &= TestAdd(P(C(1), 1),
+                 P(P(C(1), 1), 0),
+                 P(P(C(1), 1), 0, C(1), 1));
+  res &= TestAdd(P(P(C(1), 1), 0, C(1), 1),
+                 P(P(C(-1), 1), 0),
+                 P(C(1), 1));
+  res &= TestSub(P(C(1), 2, C(3), 5),
+                 P(C(1), 2, C(3), 5),
+                 C(0));
+  res &= TestAt(P(C(2), 1, C(1), 3), 2, C(12));
+  res &= TestAt(P(P(C(1), 0, C(1), 2), 1, P(C(3), 1), 2), -1, P(C(-1), 0, C(3), 1, C(-1), 2));
+  res &= TestDegBy(P(P(C(1), 1, C(1), 4), 2), 3, 0);
+  res &= TestEq(P(C(1), 1, C(2), 2), P(C(1), 1, C(3), 2), false);
+  return res;
+}
+
+static bool SingleMonoTest(void) {
+  bool res = true;
+  res &= TestAdd(P(C(3), 4), P(C(-3), 4), C(0));
+  res &= TestAdd(P(C(3), 4), P(C(-1), 4), P(C(2), 4));
+  res &= TestAdd(P(C(1), 0, C(3), 4), C(-1), P(C(3), 4));
+  res &= TestAdd(P(C(1), 1, C(3), 4), P(C(-1), 1), P(C(3), 4));
+  res &= TestMul(P(C(2), 3), P(C(-5), 4), P(C(-10), 7));
+  res &= TestMul(P(C(2), 3), P(C(1), 0, C(1), 1), P(C(2), 3, C(2), 4));
+  res &= TestMul(P(C(1L << 32), 1), P(C(1L << 32), 1), C(0));
+  res &= TestMul(P(C(1L << 32), 1), C(1L << 32), C(0));
+  res &= TestDegBy(P(C(2), 7), 0, 7);
+  res &= TestDegBy(P(C(2), 7), 4, 0);
+  res &= TestDegBy(P(P(P(P(C(1), 5), 1), 1), 1), 3, 5);
+  res &= TestDeg(P(P(C(1), 5), 2), 7);
+  res &= TestEq(P(C(2), 7), P(C(2), 7), true);
+  res &= TestEq(P(C(2), 7), P(C(2), 6), false);
+  res &= TestEq(P(C(2), 7), P(P(C(2), 7), 0), false);
+  res &= TestAt(P(C(3), 2), -2, C(12));
+
+  Poly p = P(P(C(1), 3), 2, C(-1), 5);
+  Poly q = PolyClone(&p);
+  res &= PolyIsEq(&p, &q);
+  Mono m = PolyGetMono(&q, 0);
+  res &= PolySize(&q) == 2 && PolySize(&m.p) == 1 && PolyDeg(&m.p) == 3;
+  Poly x = P(C(2), 1);
+  Poly r = PolyCompose(&p, 1, &x);
+  Poly expected = P(C(-32), 5);
+  res &= PolyIsEq(&r, &expected);
+  PolyDestroy(&r);
+  PolyDestroy(&x);
+  PolyDestroy(&q);
+  PolyDestroy(&p);
+  return res;
+}
+
+static bool GallopAddTest(void) {
+  bool res = true;
+  const size_t big = 1000;
+  for (int nested = 0; nested < 2; ++nested) {
+    Mono *huge = malloc(big * sizeof (Mono));
+    Mono *expected = malloc((big + 2) * sizeof (Mono));
+    CHECK_PTR(huge);
+    CHECK_PTR(expected);
+    for (size_t i = 0; i < big; ++i) {
+      poly_exp_t e = (poly_exp_t) (2 * i);
+      huge[i] = M(nested ? P(C(1), 1) : C(1), e);
+      expected[i] = M(nested ? P(C(1), 1) : C(1), e);
+    }
+    /* Mały wielomian ma jednomian między jednomianami dużego, jednomian za
+     * nimi oraz jednomian skracający się z jednym z nich */
+    Poly small = P(C(5), 501, nested ? P(C(-1), 1) : C(-1), 1000, C(7), 5000);
+    PolyDestroy(&expected[500].p);
+    expected[500] = M(C(5), 501);
+    expected[big] = M(C(7), 5000);
+    expected[big + 1] = M(C(0), 0);
+    Poly h = PolyOwnMonos(big, huge);
+    Poly e = PolyOwnMonos(big + 2, expected);
+    Poly sum = PolyAdd(&h, &small);
+    res &= PolyIsEq(&sum, &e);
+    PolyDestroy(&sum);
+    sum = PolyAdd(&small, &h);
+    res &= PolyIsEq(&sum, &e);
+    PolyDestroy(&sum);
+    PolyDestroy(&e);
+    PolyDestroy(&h);
+    PolyDestroy(&small);
+  }
+  return res;
+}
+
 static bool SimpleMulTest(void) {
   bool res = true;
   res &= TestMul(C(2),
@@ -3066,6 +3265,924 @@ static bool SimpleMulTest(void) {
   return res;
 }
 
+static bool MulAddTest(void) {
+  bool res = true;
+  Poly polys[] = {C(0), C(3), P(C(2), 4), P(C(1), 0, C(-1), 1),
+                  P(C(1), 1, C(1), 1000000),
+                  P(P(C(1), 1), 0, C(2), 2), P(C(-2), 2, P(C(1), 0, C(1), 3), 5),
+                  P(P(P(C(1), 2), 1, C(1), 2), 0, C(-1), 4)};
+  size_t count = sizeof (polys) / sizeof (polys[0]);
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t j = 0; j < count; ++j) {
+      for (size_t k = 0; k < count; ++k) {
+        Poly product = PolyMul(&polys[i], &polys[j]);
+        Poly expected = PolyAdd(&polys[k], &product);
+        Poly r = PolyClone(&polys[k]);
+        PolyMulAdd(&r, &polys[i], &polys[j]);
+        res &= PolyIsEq(&r, &expected);
+        PolyDestroy(&r);
+        PolyDestroy(&expected);
+        PolyDestroy(&product);
+      }
+    }
+  }
+  /* Suma iloczynów skracająca się do zera */
+  Poly r = PolyZero();
+  Poly neg = PolyNeg(&polys[6]);
+  PolyMulAdd(&r, &polys[6], &polys[7]);
+  PolyMulAdd(&r, &polys[7], &neg);
+  res &= PolyIsZero(&r);
+  /* Akumulator będący jednym z czynników */
+  r = PolyClone(&polys[3]);
+  PolyMulAdd(&r, &r, &polys[3]);
+  Poly expected = P(C(2), 0, C(-3), 1, C(1), 2);
+  res &= PolyIsEq(&r, &expected);
+  PolyDestroy(&expected);
+  PolyDestroy(&r);
+  PolyDestroy(&neg);
+  for (size_t i = 0; i < count; ++i)
+    PolyDestroy(&polys[i]);
+  return res;
+}
+
+static bool BulkCombinationTest(void) {
+  bool res = true;
+  Poly p[] = {C(0), C(3), P(C(2), 4), P(C(1), 0, C(-1), 1),
+              P(C(1), 1, C(1), 1000000),
+              P(P(C(1), 1), 0, C(2), 2), P(C(-2), 2, P(C(1), 0, C(1), 3), 5),
+              P(P(P(C(1), 2), 1, C(1), 2), 0, C(-1), 4)};
+  const size_t count = sizeof (p) / sizeof (p[0]);
+  poly_coeff_t c[] = {5, -1, 2, 0, 7, -3, 1, 4};
+  Poly q[sizeof (p) / sizeof (p[0])];
+  for (size_t i = 0; i < count; ++i) {
+    Poly shift = C((poly_coeff_t) i);
+    q[i] = PolyAdd(&p[(i * 3 + 1) % count], &shift);
+  }
+  for (size_t n = 0; n <= count; ++n) {
+    Poly comb = PolyZero(), dot = PolyZero();
+    for (size_t i = 0; i < n; ++i) {
+      Poly c_i = C(c[i]);
+      PolyMulAdd(&comb, &c_i, &p[i]);
+      PolyMulAdd(&dot, &p[i], &q[i]);
+    }
+    Poly bulk_comb = PolyLinearCombination(n, c, p);
+    Poly bulk_dot = PolyDotProduct(n, p, q);
+    res &= PolyIsEq(&bulk_comb, &comb) && PolyIsEq(&bulk_dot, &dot);
+    PolyDestroy(&bulk_comb);
+    PolyDestroy(&bulk_dot);
+    PolyDestroy(&comb);
+    PolyDestroy(&dot);
+  }
+  /* Kombinacja skracająca się do zera */
+  poly_coeff_t cancel[] = {1, 1, -2};
+  Poly twice[] = {P(C(1), 1, P(C(1), 2), 3), P(C(1), 1, P(C(1), 2), 3),
+                  P(C(1), 1, P(C(1), 2), 3)};
+  Poly zero = PolyLinearCombination(3, cancel, twice);
+  res &= PolyIsZero(&zero);
+  for (size_t i = 0; i < 3; ++i)
+    PolyDestroy(&twice[i]);
+  for (size_t i = 0; i < count; ++i) {
+    PolyDestroy(&p[i]);
+    PolyDestroy(&q[i]);
+  }
+  return res;
+}
+
+static bool AddManyTest(void) {
+  bool res = true;
+  Poly p[] = {P(C(1), 1, C(1), 1000000), C(3),
+              P(P(C(1), 1), 0, C(2), 2), P(C(-1), 1, C(-1), 1000000),
+              P(C(-2), 2, P(C(1), 0, C(1), 3), 5), C(-3),
+              P(P(P(C(1), 2), 1, C(1), 2), 0, C(-1), 4), P(P(C(-1), 1), 0)};
+  const size_t count = sizeof (p) / sizeof (p[0]);
+  for (size_t n = 0; n <= count; ++n) {
+    Poly expected = PolyZero();
+    for (size_t i = 0; i < n; ++i) {
+      Poly sum = PolyAdd(&expected, &p[i]);
+      PolyDestroy(&expected);
+      expected = sum;
+    }
+    Poly sum = PolyAddMany(n, p);
+    res &= PolyIsEq(&sum, &expected);
+    PolyDestroy(&sum);
+    PolyDestroy(&expected);
+  }
+  for (size_t i = 0; i < count; ++i)
+    PolyDestroy(&p[i]);
+  return res;
+}
+
+static bool BuilderTest(void) {
+  bool res = true;
+  /* Składniki trzech zmiennych z wieloma powtórzeniami i skróceniami */
+  PolyBuilder *b = PolyBuilderNew(3);
+  Poly expected = PolyZero();
+  unsigned long seed = 42;
+  for (size_t i = 0; i < 5000; ++i) {
+    poly_exp_t e[3];
+    for (size_t v = 0; v < 3; ++v) {
+      seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+      e[v] = (poly_exp_t) ((seed >> 33) % (v == 1 ? 40 : 6));
+    }
+    poly_coeff_t c = (poly_coeff_t) (i % 7) - 3;
+    PolyBuilderAdd(b, e, c);
+    if (c == 0)
+      continue;
+    Poly term = P(P(P(C(c), e[2]), e[1]), e[0]);
+    Poly sum = PolyAdd(&expected, &term);
+    PolyDestroy(&term);
+    PolyDestroy(&expected);
+    expected = sum;
+  }
+  Poly p = PolyBuilderFinish(b);
+  res &= PolyIsEq(&p, &expected);
+  PolyDestroy(&p);
+  PolyDestroy(&expected);
+
+  b = PolyBuilderNew(2);
+  PolyBuilderAdd(b, (poly_exp_t[]) {0, 0}, 5);
+  PolyBuilderAdd(b, (poly_exp_t[]) {3, 0}, 1);
+  PolyBuilderAdd(b, (poly_exp_t[]) {3, 0}, -1);
+  p = PolyBuilderFinish(b);
+  expected = C(5);
+  res &= PolyIsEq(&p, &expected);
+  PolyDestroy(&p);
+
+  b = PolyBuilderNew(0);
+  PolyBuilderAdd(b, NULL, 2);
+  PolyBuilderAdd(b, NULL, -2);
+  p = PolyBuilderFinish(b);
+  res &= PolyIsZero(&p);
+  return res;
+}
+
+static bool TermsTest(void) {
+  bool res = true;
+  /* Nieposortowane składniki z powtórzeniami, porównane z budowniczym */
+  enum { count = 3000, vars = 3 };
+  poly_exp_t exps[count * vars];
+  poly_coeff_t coeffs[count];
+  PolyBuilder *b = PolyBuilderNew(vars);
+  unsigned long seed = 7;
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t v = 0; v < vars; ++v) {
+      seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+      exps[i * vars + v] = (poly_exp_t) ((seed >> 33) % (v == 2 ? 300 : 5));
+    }
+    coeffs[i] = (poly_coeff_t) (i % 5) - 2;
+    PolyBuilderAdd(b, &exps[i * vars], coeffs[i]);
+  }
+  Poly p = PolyFromTerms(vars, count, exps, coeffs);
+  Poly expected = PolyBuilderFinish(b);
+  res &= PolyIsEq(&p, &expected);
+  PolyDestroy(&expected);
+
+  /* Spłaszczenie daje posortowane składniki, z których powstaje ten sam wielomian */
+  size_t size = PolyTermCount(&p);
+  res &= PolyToTerms(&p, vars, exps, coeffs) == size;
+  for (size_t i = 1; i < size; ++i) {
+    size_t v = 0;
+    while (v < vars && exps[(i - 1) * vars + v] == exps[i * vars + v])
+      ++v;
+    res &= v < vars && exps[(i - 1) * vars + v] < exps[i * vars + v];
+  }
+  Poly q = PolyFromTerms(vars, size, exps, coeffs);
+  res &= PolyIsEq(&p, &q);
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+
+  /* Wielomian zależny od mniejszej liczby zmiennych niż podana */
+  p = P(C(4), 0, P(C(2), 0, P(C(1), 3), 1), 1, C(-1), 5);
+  poly_exp_t expected_exps[] = {0, 0, 0, 1, 0, 0, 1, 1, 3, 5, 0, 0};
+  poly_coeff_t expected_coeffs[] = {4, 2, 1, -1};
+  res &= PolyTermCount(&p) == 4;
+  res &= PolyToTerms(&p, 3, exps, coeffs) == 4;
+  res &= memcmp(exps, expected_exps, sizeof(expected_exps)) == 0;
+  res &= memcmp(coeffs, expected_coeffs, sizeof(expected_coeffs)) == 0;
+  PolyDestroy(&p);
+
+  p = C(0);
+  res &= PolyTermCount(&p) == 0 && PolyToTerms(&p, 2, exps, coeffs) == 0;
+  p = PolyFromTerms(0, 2, NULL, (poly_coeff_t[]) {3, 4});
+  res &= PolyIsCoeff(&p) && p.coeff == 7;
+  return res;
+}
+
+/* Sprawdza iterator z wynikiem PolyToTerms i spójność pól opisujących drzewo */
+static bool TestTermIter(Poly p, size_t depth) {
+  bool res = PolyDepth(&p) == depth;
+  size_t count = PolyTermCount(&p);
+  poly_exp_t *exps = malloc((depth * count + 1) * sizeof(poly_exp_t));
+  poly_coeff_t *coeffs = malloc((count + 1) * sizeof(poly_coeff_t));
+  PolyTermFrame frames[8];
+  poly_exp_t it_exps[8];
+  assert(exps != NULL && coeffs != NULL && depth <= 8);
+  PolyToTerms(&p, depth, exps, coeffs);
+
+  PolyTermIter it;
+  PolyTermIterInit(&it, &p, frames, it_exps, depth);
+  size_t i = 0, next_shared = 0;
+  while (PolyTermIterNext(&it)) {
+    res &= i < count && it.coeff == coeffs[i] && it.shared == next_shared;
+    res &= it.shared < it.depth || it.depth == 0;
+    for (size_t v = 0; v < depth && i < count; ++v)
+      res &= (v < it.depth ? it.exps[v] : 0) == exps[i * depth + v];
+    next_shared = it.next_shared;
+    ++i;
+  }
+  res &= i == count && !PolyTermIterNext(&it);
+  free(exps);
+  free(coeffs);
+  PolyDestroy(&p);
+  return res;
+}
+
+static bool TermIterTest(void) {
+  bool res = true;
+  res &= TestTermIter(C(0), 0);
+  res &= TestTermIter(C(-3), 0);
+  res &= TestTermIter(P(C(2), 5), 1);
+  res &= TestTermIter(P(C(1), 0, C(2), 1, C(3), 7), 1);
+  res &= TestTermIter(P(P(C(1), 0, C(2), 1), 0, C(4), 2, P(P(C(5), 3), 1), 6), 3);
+  res &= TestTermIter(P(P(P(P(C(1), 1), 2), 0, C(3), 1), 4, P(C(7), 2), 5), 4);
+  return res;
+}
+
+static bool CoeffOfTest(void) {
+  bool res = true;
+  /* 4 + x0 (2 + x1 x2^3) - x0^5 + 3 x1^2 */
+  Poly p = P(P(C(4), 0, C(3), 2), 0, P(C(2), 0, P(C(1), 3), 1), 1,
+             C(-1), 5);
+  res &= PolyCoeffOf(&p, 0, NULL) == 4;
+  res &= PolyCoeffOf(&p, 1, (poly_exp_t[]) {0}) == 4;
+  res &= PolyCoeffOf(&p, 2, (poly_exp_t[]) {0, 2}) == 3;
+  res &= PolyCoeffOf(&p, 1, (poly_exp_t[]) {1}) == 2;
+  res &= PolyCoeffOf(&p, 3, (poly_exp_t[]) {1, 1, 3}) == 1;
+  res &= PolyCoeffOf(&p, 2, (poly_exp_t[]) {1, 1}) == 0;
+  res &= PolyCoeffOf(&p, 4, (poly_exp_t[]) {5, 0, 0, 0}) == -1;
+  res &= PolyCoeffOf(&p, 2, (poly_exp_t[]) {5, 1}) == 0;
+  res &= PolyCoeffOf(&p, 1, (poly_exp_t[]) {3}) == 0;
+  res &= PolyCoeffOf(&p, 1, (poly_exp_t[]) {9}) == 0;
+  PolyDestroy(&p);
+
+  p = P(C(7), 6);
+  res &= PolyCoeffOf(&p, 1, (poly_exp_t[]) {6}) == 7;
+  res &= PolyCoeffOf(&p, 2, (poly_exp_t[]) {6, 1}) == 0;
+  res &= PolyCoeffOf(&p, 0, NULL) == 0;
+  PolyDestroy(&p);
+
+  p = C(-2);
+  res &= PolyCoeffOf(&p, 0, NULL) == -2;
+  res &= PolyCoeffOf(&p, 2, (poly_exp_t[]) {0, 1}) == 0;
+
+  /* Każdy składnik z PolyToTerms daje swój współczynnik */
+  enum { vars = 3 };
+  PolyBuilder *b = PolyBuilderNew(vars);
+  for (poly_exp_t i = 0; i < 200; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 4, i % 7, i}, i + 1);
+  p = PolyBuilderFinish(b);
+  poly_exp_t exps[200 * vars];
+  poly_coeff_t coeffs[200];
+  size_t count = PolyToTerms(&p, vars, exps, coeffs);
+  for (size_t i = 0; i < count; ++i)
+    res &= PolyCoeffOf(&p, vars, &exps[i * vars]) == coeffs[i];
+  PolyDestroy(&p);
+  return res;
+}
+
+/* Zmienna x_var */
+static Poly Var(size_t var) {
+  Poly p = P(C(1), 1);
+  while (var-- > 0)
+    p = P(p, 0);
+  return p;
+}
+
+/* Liczba jednomianów w reprezentacji rekurencyjnej */
+static size_t MonoCount(const Poly *p) {
+  if (PolyIsCoeff(p))
+    return 0;
+  size_t count = PolySize(p);
+  for (size_t i = 0; i < PolySize(p); ++i) {
+    Mono m = PolyGetMono(p, i);
+    count += MonoCount(&m.p);
+  }
+  return count;
+}
+
+static bool PermuteVarsTest(void) {
+  bool res = true;
+  enum { vars = 4 };
+  PolyBuilder *b = PolyBuilderNew(vars);
+  for (poly_exp_t i = 0; i < 300; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 3, i % 11, i / 7, i % 2}, i - 150);
+  Poly p = PolyBuilderFinish(b);
+
+  /* Przenumerowanie jest złożeniem z q_i = x_perm[i] */
+  size_t perm[vars] = {2, 0, 3, 1}, inverse[vars];
+  Poly q[vars];
+  for (size_t i = 0; i < vars; ++i) {
+    q[i] = Var(perm[i]);
+    inverse[perm[i]] = i;
+  }
+  Poly permuted = PolyPermuteVars(&p, vars, perm);
+  Poly expected = PolyCompose(&p, vars, q);
+  res &= PolyIsEq(&permuted, &expected);
+  Poly back = PolyPermuteVars(&permuted, vars, inverse);
+  res &= PolyIsEq(&back, &p);
+  for (size_t i = 0; i < vars; ++i)
+    PolyDestroy(&q[i]);
+  PolyDestroy(&permuted);
+  PolyDestroy(&expected);
+  PolyDestroy(&back);
+
+  /* Zachłanny wybór nie powiększa reprezentacji */
+  PolyBestVarOrder(&p, vars, perm);
+  permuted = PolyPermuteVars(&p, vars, perm);
+  res &= MonoCount(&permuted) <= MonoCount(&p);
+  res &= PolyTermCount(&permuted) == PolyTermCount(&p);
+  PolyDestroy(&permuted);
+  PolyDestroy(&p);
+
+  /* Zmienna o dwóch wartościach wykładnika trafia do korzenia */
+  b = PolyBuilderNew(2);
+  for (poly_exp_t i = 0; i < 50; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i, i % 2}, 1);
+  p = PolyBuilderFinish(b);
+  PolyBestVarOrder(&p, 2, perm);
+  res &= perm[0] == 1 && perm[1] == 0;
+  permuted = PolyPermuteVars(&p, 2, perm);
+  res &= MonoCount(&permuted) == 52 && MonoCount(&p) == 75;
+  PolyDestroy(&permuted);
+
+  PolyDestroy(&p);
+
+  /* Kolejność, której nie da się poprawić, zostaje */
+  p = P(P(C(1), 0, C(2), 1), 0, P(C(3), 0, C(4), 1), 1);
+  PolyBestVarOrder(&p, 2, perm);
+  res &= perm[0] == 0 && perm[1] == 1;
+  PolyDestroy(&p);
+
+  p = C(5);
+  PolyBestVarOrder(&p, 0, perm);
+  permuted = PolyPermuteVars(&p, 0, perm);
+  res &= PolyIsEq(&p, &permuted);
+  return res;
+}
+
+/* Porównuje PolySubstitute ze złożeniem z identycznościami na pozostałych zmiennych */
+static bool TestSubstitute(const Poly *p, size_t var_idx, Poly q) {
+  enum { vars = 4 };
+  Poly args[vars];
+  for (size_t i = 0; i < vars; ++i)
+    args[i] = i == var_idx ? PolyClone(&q) : Var(i);
+  Poly expected = PolyCompose(p, vars, args);
+  Poly result = PolySubstitute(p, var_idx, &q);
+  bool res = PolyIsEq(&result, &expected);
+  for (size_t i = 0; i < vars; ++i)
+    PolyDestroy(&args[i]);
+  PolyDestroy(&expected);
+  PolyDestroy(&result);
+  PolyDestroy(&q);
+  return res;
+}
+
+static bool SubstituteTest(void) {
+  bool res = true;
+  PolyBuilder *b = PolyBuilderNew(4);
+  for (poly_exp_t i = 0; i < 40; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 3, i % 4, i / 9, i % 2}, i % 5 - 2);
+  Poly p = PolyBuilderFinish(b);
+  for (size_t var_idx = 0; var_idx < 4; ++var_idx) {
+    res &= TestSubstitute(&p, var_idx, C(0));
+    res &= TestSubstitute(&p, var_idx, C(-3));
+    /* q zależy tylko od zmiennych od x_var_idx wzwyż */
+    Poly q = P(C(1), 0, C(2), 1);
+    for (size_t i = 0; i < var_idx; ++i)
+      q = P(q, 0);
+    res &= TestSubstitute(&p, var_idx, q);
+    q = P(P(C(1), 1), 1);
+    for (size_t i = 0; i < var_idx; ++i)
+      q = P(q, 0);
+    res &= TestSubstitute(&p, var_idx, q);
+    /* q zależy od zmiennych wyższych poziomów */
+    res &= TestSubstitute(&p, var_idx, P(C(1), 0, P(C(-1), 2), 1));
+    res &= TestSubstitute(&p, var_idx, P(P(C(1), 0, P(C(5), 1), 1), 1));
+  }
+  PolyDestroy(&p);
+
+  /* x0 - x1 po podstawieniu x0 = x1 */
+  p = P(P(C(-1), 1), 0, C(1), 1);
+  Poly q = P(P(C(1), 1), 0);
+  Poly r = PolySubstitute(&p, 0, &q);
+  res &= PolyIsZero(&r);
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+
+  p = C(7);
+  q = P(C(1), 3);
+  r = PolySubstitute(&p, 1, &q);
+  res &= PolyIsEq(&r, &p);
+  PolyDestroy(&q);
+  return res;
+}
+
+/* Porównuje PolyAtMany z podstawieniem stałych i przenumerowaniem zmiennych */
+static bool TestAtMany(const Poly *p, size_t k, const size_t vars[],
+                       const poly_coeff_t values[]) {
+  enum { depth = 4 };
+  Poly args[depth];
+  size_t next = 0, evaluated = 0;
+  for (size_t j = 0; j < depth; ++j) {
+    if (evaluated < k && vars[evaluated] == j)
+      args[j] = PolyFromCoeff(values[evaluated++]);
+    else
+      args[j] = Var(next++);
+  }
+  Poly expected = PolyCompose(p, depth, args);
+  Poly result = PolyAtMany(p, k, vars, values);
+  bool res = PolyIsEq(&result, &expected);
+  for (size_t j = 0; j < depth; ++j)
+    PolyDestroy(&args[j]);
+  PolyDestroy(&result);
+  PolyDestroy(&expected);
+  return res;
+}
+
+static bool AtManyTest(void) {
+  bool res = true;
+  PolyBuilder *b = PolyBuilderNew(4);
+  for (poly_exp_t i = 0; i < 60; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 3, i % 5, i / 13, i % 4}, i % 7 - 3);
+  Poly p = PolyBuilderFinish(b);
+  poly_coeff_t values[] = {2, -1, 3, 0};
+  /* Wszystkie podzbiory zmiennych */
+  for (unsigned mask = 0; mask < 16; ++mask) {
+    size_t vars[4], k = 0;
+    poly_coeff_t chosen[4];
+    for (size_t j = 0; j < 4; ++j) {
+      if (mask & (1u << j)) {
+        vars[k] = j;
+        chosen[k++] = values[j];
+      }
+    }
+    res &= TestAtMany(&p, k, vars, chosen);
+  }
+
+  /* Ustalenie x0 i x1 to dwa kolejne wywołania PolyAt */
+  Poly first = PolyAt(&p, 5);
+  Poly expected = PolyAt(&first, -2);
+  Poly result = PolyAtMany(&p, 2, (size_t[]) {0, 1}, (poly_coeff_t[]) {5, -2});
+  res &= PolyIsEq(&result, &expected);
+  PolyDestroy(&first);
+  PolyDestroy(&expected);
+  PolyDestroy(&result);
+  PolyDestroy(&p);
+
+  /* x0 - x1 znika dla x0 = x1 = 4 */
+  p = P(P(C(-1), 1), 0, C(1), 1);
+  result = PolyAtMany(&p, 2, (size_t[]) {0, 1}, (poly_coeff_t[]) {4, 4});
+  res &= PolyIsZero(&result);
+  PolyDestroy(&p);
+  return res;
+}
+
+/* Wartość wielomianu zmiennych x_0, ..., x_{k-1} w punkcie */
+static poly_coeff_t ValueAt(const Poly *p, size_t k, const poly_coeff_t x[]) {
+  size_t vars[8];
+  for (size_t i = 0; i < k; ++i)
+    vars[i] = i;
+  Poly value = PolyAtMany(p, k, vars, x);
+  assert(PolyIsCoeff(&value));
+  return value.coeff;
+}
+
+static bool MonomialComposeTest(void) {
+  bool res = true;
+  /* x0^2 x1 + 3 x1 dla x0 = 2 x1, x1 = x0^3 */
+  Poly p = P(P(C(3), 1), 0, P(C(1), 1), 2);
+  Poly q[] = {P(P(C(2), 1), 0), P(C(1), 3)};
+  Poly r = PolyCompose(&p, 2, q);
+  Poly expected = P(P(C(3), 0, C(4), 2), 3);
+  res &= PolyIsEq(&r, &expected);
+  PolyDestroy(&r);
+  PolyDestroy(&expected);
+  PolyDestroy(&p);
+  PolyDestroy(&q[0]);
+  PolyDestroy(&q[1]);
+
+  /* Zamiana zmiennych sklejająca składniki: x0 - x1 dla x0 = x1 = x2 */
+  p = P(P(C(-1), 1), 0, C(1), 1);
+  Poly x2[] = {P(P(P(C(1), 1), 0), 0), P(P(P(C(1), 1), 0), 0)};
+  r = PolyCompose(&p, 2, x2);
+  res &= PolyIsZero(&r);
+  PolyDestroy(&p);
+  PolyDestroy(&x2[0]);
+  PolyDestroy(&x2[1]);
+
+  /* Losowy wielomian porównany w punktach z wartościami podstawień */
+  PolyBuilder *b = PolyBuilderNew(4);
+  for (poly_exp_t i = 0; i < 80; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 3, i % 5, i / 17, i % 4}, i % 9 - 4);
+  p = PolyBuilderFinish(b);
+  Poly subst[] = {P(P(C(-2), 2), 0), C(3), P(C(1), 1), P(P(C(5), 1), 0)};
+  for (size_t k = 0; k <= 4; ++k) {
+    r = PolyCompose(&p, k, subst);
+    for (poly_coeff_t point = -3; point <= 3; ++point) {
+      poly_coeff_t x[] = {point, point * point - 1};
+      poly_coeff_t q_values[4] = {0, 0, 0, 0};
+      for (size_t i = 0; i < k; ++i)
+        q_values[i] = ValueAt(&subst[i], 2, x);
+      res &= ValueAt(&r, 2, x) == ValueAt(&p, 4, q_values);
+    }
+    PolyDestroy(&r);
+  }
+  for (size_t i = 0; i < 4; ++i)
+    PolyDestroy(&subst[i]);
+  PolyDestroy(&p);
+  return res;
+}
+
+static bool ShiftTest(void) {
+  bool res = true;
+  /* x^2 + 3 dla x = x + 1 */
+  Poly p = P(C(3), 0, C(1), 2);
+  Poly r = PolyShift(&p, 0, 1);
+  Poly expected = P(C(4), 0, C(2), 1, C(1), 2);
+  res &= PolyIsEq(&r, &expected);
+  PolyDestroy(&p);
+  PolyDestroy(&r);
+  PolyDestroy(&expected);
+
+  /* Wysokie stopnie z liczbowymi i wielomianowymi współczynnikami
+   * porównane w punktach */
+  PolyBuilder *b = PolyBuilderNew(3);
+  for (poly_exp_t i = 0; i < 120; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i * 7 % 150, i % 4, i % 3}, i % 11 - 5);
+  p = PolyBuilderFinish(b);
+  for (size_t var = 0; var < 4; ++var) {
+    for (poly_coeff_t a = -2; a <= 3; a += 5) {
+      r = PolyShift(&p, var, a);
+      for (poly_coeff_t point = -2; point <= 2; ++point) {
+        poly_coeff_t x[] = {point, 3 - point, point * 2};
+        poly_coeff_t shifted[] = {x[0], x[1], x[2]};
+        if (var < 3)
+          shifted[var] += a;
+        res &= ValueAt(&r, 3, x) == ValueAt(&p, 3, shifted);
+      }
+      PolyDestroy(&r);
+    }
+  }
+
+  /* Złożenie z wielomianami postaci b x_i + a */
+  Poly q[] = {P(C(1), 0, C(2), 1), P(P(C(-1), 0, C(1), 1), 0), C(4)};
+  for (size_t k = 1; k <= 3; ++k) {
+    r = PolyCompose(&p, k, q);
+    for (poly_coeff_t point = -2; point <= 2; ++point) {
+      poly_coeff_t x[] = {point, point + 5, 0};
+      poly_coeff_t q_values[] = {1 + 2 * x[0], x[1] - 1, 4};
+      for (size_t i = k; i < 3; ++i)
+        q_values[i] = 0;
+      res &= ValueAt(&r, 2, x) == ValueAt(&p, 3, q_values);
+    }
+    PolyDestroy(&r);
+  }
+  for (size_t i = 0; i < 3; ++i)
+    PolyDestroy(&q[i]);
+
+  /* Podstawienie x_1 = x_1 + 1 przez PolySubstitute */
+  Poly q1 = P(P(C(1), 0, C(1), 1), 0);
+  r = PolySubstitute(&p, 1, &q1);
+  expected = PolyShift(&p, 1, 1);
+  res &= PolyIsEq(&r, &expected);
+  PolyDestroy(&q1);
+  PolyDestroy(&r);
+  PolyDestroy(&expected);
+  PolyDestroy(&p);
+  return res;
+}
+
+static bool TestMulMono(const Poly *p, size_t var_idx, poly_exp_t e,
+                        poly_coeff_t c) {
+  Poly mono = C(c);
+  if (e > 0) {
+    PolyDestroy(&mono);
+    Poly var = Var(var_idx);
+    Poly pow = C(1);
+    for (poly_exp_t i = 0; i < e; ++i) {
+      Poly next = PolyMul(&pow, &var);
+      PolyDestroy(&pow);
+      pow = next;
+    }
+    Poly coeff = C(c);
+    mono = PolyMul(&pow, &coeff);
+    PolyDestroy(&var);
+    PolyDestroy(&pow);
+  }
+  Poly expected = PolyMul(p, &mono);
+  Poly r = PolyClone(p);
+  PolyMulMono(&r, var_idx, e, c);
+  bool res = PolyIsEq(&r, &expected);
+  PolyDestroy(&mono);
+  PolyDestroy(&expected);
+  PolyDestroy(&r);
+  return res;
+}
+
+static bool MulMonoTest(void) {
+  bool res = true;
+  PolyBuilder *b = PolyBuilderNew(3);
+  for (poly_exp_t i = 0; i < 40; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 7, i % 3 * 2, i % 5}, (i % 9 - 4) * 2);
+  Poly p[] = {
+    PolyBuilderFinish(b), C(5), C(0), P(C(3), 4), P(C(1), 0, C(-2), 3),
+    P(P(C(1), 0, C(2), 2), 1), P(C(2), 0, P(C(1), 1), 2)
+  };
+  poly_coeff_t c[] = {1, -3, 0, 1L << 62};
+  for (size_t i = 0; i < sizeof(p) / sizeof(p[0]); ++i) {
+    for (size_t var = 0; var < 5; ++var)
+      for (poly_exp_t e = 0; e < 3; ++e)
+        for (size_t j = 0; j < sizeof(c) / sizeof(c[0]); ++j)
+          res &= TestMulMono(&p[i], var, e, c[j]);
+    PolyDestroy(&p[i]);
+  }
+  return res;
+}
+
+static bool TruncTest(void) {
+  bool res = true;
+  PolyBuilder *b = PolyBuilderNew(3);
+  for (poly_exp_t i = 0; i < 30; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 5, i % 3, i % 7 / 2}, i % 7 - 3);
+  Poly p = PolyBuilderFinish(b);
+  b = PolyBuilderNew(2);
+  for (poly_exp_t i = 0; i < 12; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i * 3 % 8, i % 2}, i - 5);
+  Poly q = PolyBuilderFinish(b);
+  Poly flat = P(C(1), 0, C(-2), 1, C(3), 4, C(5), 9);
+  Poly polys[] = {p, q, flat, P(C(7), 3), C(2)};
+  size_t count = sizeof(polys) / sizeof(polys[0]);
+
+  for (poly_exp_t d = -1; d <= 14; ++d) {
+    for (size_t i = 0; i < count; ++i) {
+      for (size_t j = 0; j < count; ++j) {
+        Poly full = PolyMul(&polys[i], &polys[j]);
+        Poly expected = PolyTruncate(&full, d);
+        Poly r = PolyMulTrunc(&polys[i], &polys[j], d);
+        res &= PolyIsEq(&r, &expected);
+        res &= PolyDeg(&r) <= d;
+        PolyDestroy(&full);
+        PolyDestroy(&expected);
+        PolyDestroy(&r);
+      }
+
+      Poly power = C(1);
+      for (poly_exp_t n = 0; n <= 4; ++n) {
+        Poly expected = PolyTruncate(&power, d);
+        Poly r = PolyPowTrunc(&polys[i], n, d);
+        res &= PolyIsEq(&r, &expected);
+        PolyDestroy(&expected);
+        PolyDestroy(&r);
+        Poly next = PolyMul(&power, &polys[i]);
+        PolyDestroy(&power);
+        power = next;
+      }
+      PolyDestroy(&power);
+    }
+
+    /* Podstawienia z wyrazem wolnym i bez niego */
+    Poly args[] = {P(C(1), 0, C(1), 1), P(P(C(1), 2), 1), C(3)};
+    for (size_t k = 0; k <= 3; ++k) {
+      Poly full = PolyCompose(&p, k, args);
+      Poly expected = PolyTruncate(&full, d);
+      Poly r = PolyComposeTrunc(&p, k, args, d);
+      res &= PolyIsEq(&r, &expected);
+      PolyDestroy(&full);
+      PolyDestroy(&expected);
+      PolyDestroy(&r);
+    }
+    for (size_t i = 0; i < 3; ++i)
+      PolyDestroy(&args[i]);
+  }
+
+  /* Obcinanie zachowuje jednomiany stopnia co najwyżej d */
+  Poly truncated = PolyTruncate(&flat, 4);
+  Poly expected = P(C(1), 0, C(-2), 1, C(3), 4);
+  res &= PolyIsEq(&truncated, &expected);
+  PolyDestroy(&truncated);
+  PolyDestroy(&expected);
+  for (size_t i = 0; i < count; ++i)
+    PolyDestroy(&polys[i]);
+  return res;
+}
+
+/* Współczynniki iloczynu szeregów zmiennej x_0 modulo x^n i modulo m */
+static void SeriesMulMod(const Poly *a, const Poly *b, poly_exp_t n,
+                         poly_coeff_t m, poly_coeff_t res[]) {
+  for (poly_exp_t i = 0; i < n; ++i) {
+    res[i] = 0;
+    for (poly_exp_t j = 0; j <= i; ++j) {
+      poly_exp_t k = i - j;
+      poly_coeff_t x = PolyCoeffOf(a, 1, &j) % m, y = PolyCoeffOf(b, 1, &k) % m;
+      res[i] = (res[i] + (x + m) % m * ((y + m) % m)) % m;
+    }
+  }
+}
+
+static bool SeriesTest(void) {
+  bool res = true;
+  const poly_coeff_t prime = 998244353;
+  Poly f = P(C(3), 0, C(-5), 1, C(7), 2, C(1), 5, C(-2), 40);
+  poly_exp_t lengths[] = {0, 1, 2, 5, 17, 64};
+  for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+    poly_exp_t n = lengths[i];
+    Poly g, product;
+    res &= PolySeriesInv(&f, n, 0, &g);
+    product = PolyMulTrunc(&f, &g, n - 1);
+    Poly one = C(n > 0);
+    res &= PolyIsEq(&product, &one);
+    PolyDestroy(&product);
+    PolyDestroy(&g);
+
+    poly_coeff_t coeffs[64];
+    res &= PolySeriesInv(&f, n, prime, &g);
+    SeriesMulMod(&f, &g, n, prime, coeffs);
+    for (poly_exp_t j = 0; j < n; ++j)
+      res &= coeffs[j] == (j == 0);
+    PolyDestroy(&g);
+  }
+
+  /* 1 / (1 + x) modulo 7 */
+  Poly g;
+  Poly one_plus_x = P(C(1), 0, C(1), 1);
+  res &= PolySeriesInv(&one_plus_x, 4, 7, &g);
+  Poly expected = P(C(1), 0, C(6), 1, C(1), 2, C(6), 3);
+  res &= PolyIsEq(&g, &expected);
+  PolyDestroy(&g);
+  PolyDestroy(&expected);
+
+  /* sqrt(1 - 4x) to 1 minus podwojone liczby Catalana */
+  Poly catalan = P(C(1), 0, C(-4), 1);
+  res &= PolySeriesSqrt(&catalan, 6, 0, &g);
+  expected = P(C(1), 0, C(-2), 1, C(-2), 2, C(-4), 3, C(-10), 4, C(-28), 5);
+  res &= PolyIsEq(&g, &expected);
+  PolyDestroy(&g);
+  PolyDestroy(&expected);
+  PolyDestroy(&catalan);
+
+  Poly root = P(C(1), 0, C(2), 1, C(-6), 3, C(10), 20);
+  Poly square = PolyMul(&root, &root);
+  res &= PolySeriesSqrt(&square, 30, 0, &g);
+  Poly g_square = PolyMulTrunc(&g, &g, 29);
+  Poly truncated = PolyTruncate(&square, 29);
+  res &= PolyIsEq(&g_square, &truncated);
+  PolyDestroy(&g);
+  PolyDestroy(&g_square);
+  PolyDestroy(&truncated);
+
+  /* Modulo liczby pierwszej pierwiastek o wyrazie wolnym 1 jest jedyny */
+  Poly root_mod = P(C(1), 0, C(2), 1, C(prime - 6), 3, C(10), 20);
+  res &= PolySeriesSqrt(&square, 25, prime, &g);
+  poly_coeff_t coeffs[25];
+  SeriesMulMod(&g, &g, 25, prime, coeffs);
+  for (poly_exp_t j = 0; j < 25; ++j) {
+    poly_coeff_t expected_coeff = PolyCoeffOf(&square, 1, &j) % prime;
+    res &= coeffs[j] == (expected_coeff + prime) % prime;
+  }
+  res &= PolyIsEq(&g, &root_mod);
+  PolyDestroy(&g);
+  PolyDestroy(&root_mod);
+  PolyDestroy(&square);
+  PolyDestroy(&root);
+
+  /* exp(x) ma współczynniki 1 / k! */
+  Poly x = P(C(1), 1);
+  res &= PolySeriesExp(&x, 20, prime, &g);
+  poly_coeff_t factorial = 1;
+  for (poly_exp_t k = 0; k < 20; ++k) {
+    if (k > 0)
+      factorial = factorial * k % prime;
+    res &= PolyCoeffOf(&g, 1, &k) * factorial % prime == 1;
+  }
+  PolyDestroy(&g);
+
+  /* exp(h) exp(-h) = 1 */
+  Poly h = P(C(3), 1, C(-1), 2, C(5), 7);
+  Poly neg_h = PolyNeg(&h);
+  Poly e1, e2;
+  res &= PolySeriesExp(&h, 50, prime, &e1);
+  res &= PolySeriesExp(&neg_h, 50, prime, &e2);
+  poly_coeff_t product[50];
+  SeriesMulMod(&e1, &e2, 50, prime, product);
+  for (poly_exp_t j = 0; j < 50; ++j)
+    res &= product[j] == (j == 0);
+  PolyDestroy(&e1);
+  PolyDestroy(&e2);
+  PolyDestroy(&neg_h);
+
+  /* Stałe są szeregami o jednym wyrazie */
+  for (poly_exp_t n = 0; n <= 3; ++n) {
+    Poly three = C(3), zero = C(0), one = C(1);
+    res &= PolySeriesInv(&three, n, 0, &g);
+    Poly product = PolyMul(&three, &g);
+    expected = C(n > 0);
+    res &= PolyIsEq(&product, &expected);
+    PolyDestroy(&product);
+    PolyDestroy(&g);
+    res &= PolySeriesInv(&three, n, 7, &g);
+    expected = C(n == 0 ? 0 : 5);
+    res &= PolyIsEq(&g, &expected);
+    PolyDestroy(&g);
+    res &= PolySeriesSqrt(&one, n, 0, &g);
+    expected = C(n > 0);
+    res &= PolyIsEq(&g, &expected);
+    PolyDestroy(&g);
+    res &= PolySeriesExp(&zero, n, 7, &g);
+    res &= PolyIsEq(&g, &expected);
+    PolyDestroy(&g);
+
+    Poly two = C(2), four = C(4);
+    res &= !PolySeriesInv(&two, n, 0, &g);
+    res &= !PolySeriesSqrt(&four, n, 0, &g);
+    res &= !PolySeriesExp(&one, n, 7, &g);
+  }
+
+  /* Wyniki, które nie istnieją */
+  Poly even = P(C(2), 0, C(1), 1);
+  Poly deep = P(P(C(1), 1), 0);
+  res &= !PolySeriesInv(&even, 5, 0, &g);
+  res &= !PolySeriesInv(&f, 5, 3, &g);
+  res &= !PolySeriesInv(&deep, 5, 0, &g);
+  res &= !PolySeriesSqrt(&f, 5, 0, &g);
+  res &= !PolySeriesSqrt(&one_plus_x, 5, 0, &g);
+  res &= !PolySeriesSqrt(&one_plus_x, 5, 4, &g);
+  res &= !PolySeriesExp(&h, 5, 0, &g);
+  res &= !PolySeriesExp(&one_plus_x, 5, prime, &g);
+  res &= !PolySeriesExp(&h, 6, 5, &g);
+  PolyDestroy(&even);
+  PolyDestroy(&deep);
+  PolyDestroy(&h);
+  PolyDestroy(&x);
+  PolyDestroy(&one_plus_x);
+  PolyDestroy(&f);
+  return res;
+}
+
+static bool DivRemTest(void) {
+  bool res = true;
+  PolyBuilder *b = PolyBuilderNew(3);
+  for (poly_exp_t i = 0; i < 40; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 9, i % 4, i % 5 / 2}, i % 11 - 5);
+  Poly p = PolyBuilderFinish(b);
+  b = PolyBuilderNew(2);
+  for (poly_exp_t i = 0; i < 6; ++i)
+    PolyBuilderAdd(b, (poly_exp_t[]) {i % 3, i % 2 + 1}, i - 2);
+  PolyBuilderAdd(b, (poly_exp_t[]) {3, 0}, 1);
+  Poly d = PolyBuilderFinish(b);
+  Poly divisors[] = {d, P(C(2), 0, C(-3), 1, C(1), 4), P(C(1), 1), C(1)};
+  Poly dividends[] = {p, P(C(5), 2), C(-7), C(0)};
+
+  for (size_t i = 0; i < sizeof(divisors) / sizeof(divisors[0]); ++i) {
+    for (size_t j = 0; j < sizeof(dividends) / sizeof(dividends[0]); ++j) {
+      Poly q, r;
+      res &= PolyDivRem(&dividends[j], &divisors[i], &q, &r);
+      Poly qd = PolyMul(&q, &divisors[i]);
+      Poly sum = PolyAdd(&qd, &r);
+      res &= PolyIsEq(&sum, &dividends[j]);
+      res &= PolyDegBy(&r, 0) < PolyDegBy(&divisors[i], 0);
+      PolyDestroy(&qd);
+      PolyDestroy(&sum);
+
+      Poly product = PolyMul(&dividends[j], &divisors[i]), exact;
+      res &= PolyDivExact(&product, &divisors[i], &exact);
+      res &= PolyIsEq(&exact, &dividends[j]);
+      PolyDestroy(&exact);
+      PolyDestroy(&product);
+      res &= PolyIsZero(&r) == PolyDivExact(&dividends[j], &divisors[i], &exact);
+      if (PolyIsZero(&r)) {
+        res &= PolyIsEq(&exact, &q);
+        PolyDestroy(&exact);
+      }
+      PolyDestroy(&q);
+      PolyDestroy(&r);
+    }
+  }
+
+  Poly q, r;
+  Poly not_monic[] = {C(2), C(0), P(C(2), 1), P(C(1), 0, P(C(1), 1), 2)};
+  for (size_t i = 0; i < sizeof(not_monic) / sizeof(not_monic[0]); ++i) {
+    res &= !PolyDivRem(&p, &not_monic[i], &q, &r);
+    res &= !PolyDivExact(&p, &not_monic[i], &q);
+    PolyDestroy(&not_monic[i]);
+  }
+
+  for (size_t i = 0; i < sizeof(divisors) / sizeof(divisors[0]); ++i)
+    PolyDestroy(&divisors[i]);
+  for (size_t j = 0; j < sizeof(dividends) / sizeof(dividends[0]); ++j)
+    PolyDestroy(&dividends[j]);
+  return res;
+}
+
 static bool SimpleNegTest(void) {
   Poly a = P(P(C(1), 0, C(2), 2), 0, P(C(1), 1), 1, C(1), 2);
   Poly b = PolyNeg(&a);
@@ -3503,6 +4620,38 @@ static bool DegByTest(void) {
   return result;
 }
 
+/**
+ * Sprawdza, czy stopnie wielomianów są poprawne po operacjach tworzących
+ * nowe wielomiany.
+ */
+static bool DegAfterOpTest(void) {
+  bool res = true;
+  Poly p = P(P(C(1), 2), 1, P(P(C(1), 3), 1), 2, C(3), 4);
+  Poly q = PolyMul(&p, &p);
+  res &= PolyDeg(&q) == 12 && PolyDegBy(&q, 0) == 8 &&
+         PolyDegBy(&q, 1) == 4 && PolyDegBy(&q, 2) == 6 &&
+         PolyDegBy(&q, 3) == 0;
+  Poly r = PolyNeg(&q);
+  Poly s = PolyClone(&r);
+  res &= PolyDeg(&s) == 12 && PolyDegBy(&s, 2) == 6;
+  Poly t = PolyAdd(&q, &s);
+  res &= PolyDeg(&t) == -1 && PolyDegBy(&t, 1) == -1;
+  Poly x = P(C(1), 2);
+  Poly u = PolyCompose(&p, 1, &x);
+  res &= PolyDeg(&u) == 8 && PolyDegBy(&u, 0) == 8 && PolyDegBy(&u, 1) == 0;
+  Poly v = PolyAt(&p, 2);
+  res &= PolyDeg(&v) == 4 && PolyDegBy(&v, 0) == 2 && PolyDegBy(&v, 1) == 3;
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+  PolyDestroy(&r);
+  PolyDestroy(&s);
+  PolyDestroy(&t);
+  PolyDestroy(&x);
+  PolyDestroy(&u);
+  PolyDestroy(&v);
+  return res;
+}
+
 /**
  * Sprawdza mnożenie, korzystając ze wzorów skróconego mnożenia.
  */
@@ -3922,6 +5071,64 @@ static bool RarePolynomialTest(void) {
   return result;
 }
 
+/**
+ * Buduje wielomian postaci @f$x_0(x_1(\ldots x_{depth - 1}(c)))@f$.
+ * @param depth głębokość (liczba zmiennych) wielomianu
+ * @param c współczynnik na najgłębszym poziomie
+ */
+static Poly DeepPoly(size_t depth, poly_coeff_t c) {
+  Poly p = PolyFromCoeff(c);
+  for (size_t i = 0; i < depth; ++i) {
+    Mono m = MonoFromPoly(&p, 1);
+    p = PolyAddMonos(1, &m);
+  }
+  return p;
+}
+
+/**
+ * Sprawdza operacje na wielomianach o bardzo dużej liczbie zmiennych.
+ * Rekurencja po kolejnych zmiennych przepełniłaby stos wywołań.
+ */
+static bool DeepPolynomialTest(void) {
+  const size_t depth = 2000000;
+  bool res = true;
+  Poly p = DeepPoly(depth, 1);
+  Poly q = DeepPoly(depth, 2);
+  Poly r = PolyClone(&p);
+  res &= PolyDeg(&p) == (poly_exp_t)depth;
+  res &= PolyDegBy(&p, 0) == 1;
+  res &= PolyDegBy(&p, depth - 1) == 1;
+  res &= PolyDegBy(&p, depth) == 0;
+  res &= !PolyIsZero(&p);
+  res &= PolyIsEq(&p, &r);
+  res &= !PolyIsEq(&p, &q);
+  res &= PolyDepth(&p) == depth;
+
+  PolyTermFrame *frames = malloc(depth * sizeof(PolyTermFrame));
+  poly_exp_t *exps = malloc(depth * sizeof(poly_exp_t));
+  assert(frames != NULL && exps != NULL);
+  PolyTermIter it;
+  PolyTermIterInit(&it, &q, frames, exps, depth);
+  res &= PolyTermIterNext(&it);
+  res &= it.depth == depth && it.coeff == 2;
+  for (size_t i = 0; i < depth; ++i)
+    res &= exps[i] == 1;
+  res &= !PolyTermIterNext(&it);
+  free(frames);
+
+  poly_coeff_t coeff;
+  res &= PolyTermCount(&p) == 1;
+  res &= PolyToTerms(&q, depth, exps, &coeff) == 1 && coeff == 2;
+  for (size_t i = 0; i < depth; ++i)
+    res &= exps[i] == 1;
+  free(exps);
+
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+  PolyDestroy(&r);
+  return res;
+}
+
 /**
  * Sprawdza, czy funkcje PolyAddMonos i MonoFromPoly przejmują na własność
  * jednomiany i wielomiany.
@@ -3982,7 +5189,7 @@ static bool AtGroup(void) {
 }
 
 static bool DegGroup(void) {
-  return DegTest() && DegByTest();
+  return DegTest() && DegByTest() && DegAfterOpTest();
 }
 
 static bool ArithmeticGroup(void) {
@@ -3992,7 +5199,8 @@ static bool ArithmeticGroup(void) {
 }
 
 static bool MemoryGroup(void) {
-  return RarePolynomialTest() && MemoryThiefTest() && MemoryFreeTest();
+  return RarePolynomialTest() && DeepPolynomialTest() &&
+         MemoryThiefTest() && MemoryFreeTest();
 }
 
 /** URUCHAMIANIE TESTÓW **/
@@ -4015,7 +5223,29 @@ typedef struct {
 static const test_list_t test_list[] = {
   TEST(SimpleAddTest),
   TEST(SimpleAddMonosTest),
+  TEST(AddMonosOrderTest),
+  TEST(OwnCloneMonosTest),
+  TEST(MonosConversionTest),
+  TEST(LeafKernelsTest),
+  TEST(SingleMonoTest),
+  TEST(GallopAddTest),
   TEST(SimpleMulTest),
+  TEST(MulAddTest),
+  TEST(BulkCombinationTest),
+  TEST(AddManyTest),
+  TEST(BuilderTest),
+  TEST(TermsTest),
+  TEST(TermIterTest),
+  TEST(CoeffOfTest),
+  TEST(PermuteVarsTest),
+  TEST(SubstituteTest),
+  TEST(AtManyTest),
+  TEST(MonomialComposeTest),
+  TEST(ShiftTest),
+  TEST(MulMonoTest),
+  TEST(TruncTest),
+  TEST(SeriesTest),
+  TEST(DivRemTest),
   TEST(SimpleNegTest),
   TEST(SimpleSubTest),
   TEST(SimpleNegGroup),
@@ -4033,6 +5263,7 @@ static const test_list_t test_list[] = {
   TEST(DegreeOpChangeTest),
   TEST(DegTest),
   TEST(DegByTest),
+  TEST(DegAfterOpTest),
   TEST(DegGroup),
   TEST(MulTest1),
   TEST(MulTest2),
@@ -4043,6 +5274,7 @@ static const test_list_t test_list[] = {
   TEST(ArithmeticGroup),
   TEST(IsEqTest),
   TEST(RarePolynomialTest),
+  TEST(DeepPolynomialTest),
   TEST(MemoryThiefTest),
   TEST(MemoryFreeTest),
   TEST(MemoryGroup),
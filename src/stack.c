@@ -26,6 +26,11 @@ static void IncreaseStackSize(Stack *s) {
 void Push(Stack *s, Poly *p) {
     if (s->size == s->arr_size)
         IncreaseStackSize(s);
+    if (s->deg_bound != NO_DEG_BOUND && PolyDeg(p) > s->deg_bound) {
+        Poly truncated = PolyTruncate(p, s->deg_bound);
+        PolyDestroy(p);
+        *p = truncated;
+    }
     s->arr[s->size++] = *p;
 }
 
@@ -71,6 +76,7 @@ Stack GetNewStack() {
         s.arr = arr;
     s.size = 0;
     s.arr_size = INITIAL_STACK_ARR_SIZE;
+    s.deg_bound = NO_DEG_BOUND;
     return s;
 }
 
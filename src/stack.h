@@ -9,6 +9,8 @@
 
 #include "poly.h"
 
+/** Wartość pola @p deg_bound stosu oznaczająca brak ograniczenia stopnia. */
+#define NO_DEG_BOUND -1
 
 /**
  * Stos zaimplementowany na tablicy;
@@ -20,10 +22,15 @@ typedef struct {
     size_t size;
     /** Rozmiar tablicy @p arr */
     size_t arr_size;
+    /** Ograniczenie stopnia wielomianów wstawianych na stos lub
+     *  @ref NO_DEG_BOUND */
+    poly_exp_t deg_bound;
 } Stack;
 
 /**
- * Dodaje wielomian na górę stosu.
+ * Dodaje wielomian na górę stosu. Jeśli stos ma ograniczenie stopnia, a
+ * wielomian je przekracza, na stos trafia wielomian obcięty do tego stopnia
+ * (patrz @ref PolyTruncate), a @p p jest usuwany.
  * @param s : stos
  * @param p : wielomian
  */